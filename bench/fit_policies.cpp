@@ -0,0 +1,128 @@
+// Сравнение стратегий размещения BasicMemoryResource на общей нагрузке.
+//
+// Нагрузка: случайная смесь аллокаций (в основном мелкие узлы 16..128 байт,
+// изредка крупные блоки 256..2048 байт) и освобождений случайных живых блоков.
+// Для всех стратегий используется одна и та же последовательность операций.
+// Второй проход повторяет ее через allocate_near с подсказкой - последним
+// живым блоком, как это делают контейнеры (DoublyLinkedList).
+
+#include "MemoryResource.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Op
+{
+    bool allocate;
+    std::size_t size;
+    std::size_t victim; // индекс освобождаемого блока среди живых
+};
+
+std::vector<Op> make_workload(std::size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> small(16, 128);
+    std::uniform_int_distribution<std::size_t> large(256, 2048);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<std::size_t> any;
+
+    std::vector<Op> ops;
+    ops.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // 55% аллокаций: живое множество медленно растет до заполнения арены
+        if (percent(rng) < 55)
+            ops.push_back({true, percent(rng) < 90 ? small(rng) : large(rng), 0});
+        else
+            ops.push_back({false, 0, any(rng)});
+    }
+    return ops;
+}
+
+struct Live
+{
+    void *p;
+    std::size_t size;
+};
+
+template <typename Resource>
+void run(const std::vector<Op> &ops, std::size_t arena_size, bool hinted)
+{
+    Resource mr(arena_size);
+    mr.set_verbose(false);
+
+    std::vector<Live> live;
+    std::size_t failures = 0;
+    double worst_fragmentation = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Op &op : ops)
+    {
+        if (op.allocate)
+        {
+            try
+            {
+                const void *hint = hinted && !live.empty() ? live.back().p : nullptr;
+                void *p = hinted ? mr.allocate_near(hint, op.size, 8) : mr.allocate(op.size, 8);
+                live.push_back({p, op.size});
+            }
+            catch (const std::bad_alloc &)
+            {
+                ++failures;
+                // Доля свободной памяти, недоступной одним блоком
+                double fragmentation =
+                    1.0 - static_cast<double>(mr.largest_free_block()) / mr.free_bytes();
+                if (fragmentation > worst_fragmentation)
+                    worst_fragmentation = fragmentation;
+            }
+        }
+        else if (!live.empty())
+        {
+            std::size_t i = op.victim % live.size();
+            mr.deallocate(live[i].p, live[i].size, 8);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+
+    std::size_t free_bytes = mr.free_bytes();
+    double fragmentation = free_bytes
+        ? 1.0 - static_cast<double>(mr.largest_free_block()) / free_bytes
+        : 0.0;
+
+    std::printf("%-12s %10.1f %10zu %10zu %12.3f %12.3f\n",
+                Resource::policy_type::name, ms, failures, mr.free_block_count(),
+                fragmentation, worst_fragmentation);
+
+    for (const Live &l : live)
+        mr.deallocate(l.p, l.size, 8);
+}
+
+} // namespace
+
+int main()
+{
+    const std::size_t arena_size = 256 * 1024;
+    const std::vector<Op> ops = make_workload(50000);
+
+    std::printf("arena: %zu bytes, operations: %zu\n\n", arena_size, ops.size());
+
+    for (bool hinted : {false, true})
+    {
+        std::printf("%s\n", hinted ? "\nallocate_near (hint = last live block):" : "allocate:");
+        std::printf("%-12s %10s %10s %10s %12s %12s\n",
+                    "policy", "time, ms", "failures", "holes", "frag (end)", "frag (worst)");
+
+        run<MemoryResource>(ops, arena_size, hinted);
+        run<NextFitMemoryResource>(ops, arena_size, hinted);
+        run<BestFitMemoryResource>(ops, arena_size, hinted);
+        run<SegregatedMemoryResource>(ops, arena_size, hinted);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+// Доля попаданий и пропускная способность LruCache в режимах Lru и
+// SegmentedLru. Ключи выбираются по распределению, близкому к Зипфу, с
+// периодическими однократными "сканами" по холодным ключам.
+
+#include "LruCache.h"
+#include "MemoryResource.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<int> make_workload(std::size_t count, int key_space)
+{
+    std::mt19937 rng(7);
+
+    // Вероятность ключа k пропорциональна 1 / (k + 1)
+    std::vector<double> weights(key_space);
+    for (int k = 0; k < key_space; ++k)
+        weights[k] = 1.0 / (k + 1);
+    std::discrete_distribution<int> zipf(weights.begin(), weights.end());
+
+    std::vector<int> keys;
+    keys.reserve(count);
+    int scan_key = key_space;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // Каждая десятая тысяча операций - скан по ключам, не встречающимся повторно
+        if ((i / 1000) % 10 == 9)
+            keys.push_back(scan_key++);
+        else
+            keys.push_back(zipf(rng));
+    }
+    return keys;
+}
+
+void run(const char *label, CacheMode mode, const std::vector<int> &keys, std::size_t capacity)
+{
+    MemoryResource mr(16 * 1024 * 1024);
+    mr.set_verbose(false);
+    {
+        LruCache<int, long> cache(capacity, &mr, mode);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int key : keys)
+        {
+            if (!cache.get(key))
+                cache.put(key, static_cast<long>(key) * 2);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double lookups = static_cast<double>(cache.hits() + cache.misses());
+        std::printf("%-14s %10.2f%% %14.0f %12zu\n", label,
+                    100.0 * cache.hits() / lookups, keys.size() / seconds, cache.evictions());
+    }
+}
+
+} // namespace
+
+int main()
+{
+    const std::size_t capacity = 1000;
+    const std::vector<int> keys = make_workload(200000, 20000);
+
+    std::printf("capacity: %zu, operations: %zu\n\n", capacity, keys.size());
+    std::printf("%-14s %11s %14s %12s\n", "mode", "hit rate", "ops/sec", "evictions");
+
+    run("lru", CacheMode::Lru, keys, capacity);
+    run("segmented-lru", CacheMode::SegmentedLru, keys, capacity);
+
+    return 0;
+}
\ No newline at end of file
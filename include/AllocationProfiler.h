@@ -0,0 +1,106 @@
+#ifndef ALLOCATION_PROFILER_H
+#define ALLOCATION_PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Выборочный профилировщик аллокаций.
+//
+// В среднем одна выборка на sample_interval байт (интервалы между выборками
+// распределены экспоненциально, как в tcmalloc, поэтому крупные и мелкие
+// блоки попадают в выборку без смещения). Для выбранного блока
+// запоминается место вызова: тег активного ProfileScope или, если тега нет,
+// стек вызовов. Живые выбранные блоки отслеживаются до освобождения;
+// dump() печатает оценку занятой памяти по местам вызова.
+//
+// BasicMemoryResource вызывает профилировщик только при сборке с
+// PMR_ENABLE_PROFILER; без него в горячем пути нет никаких проверок.
+class AllocationProfiler
+{
+public:
+    struct SiteStats
+    {
+        std::string site;
+        std::size_t live_samples;
+        double live_bytes;          // оценка с учетом частоты выборки
+        std::size_t total_samples;
+    };
+
+    explicit AllocationProfiler(std::size_t sample_interval = 512 * 1024, unsigned seed = 1);
+
+    AllocationProfiler(const AllocationProfiler &) = delete;
+    AllocationProfiler &operator=(const AllocationProfiler &) = delete;
+
+    // Быстрый путь: true, если эту аллокацию нужно записать через record()
+    bool should_sample(std::size_t bytes)
+    {
+        if (bytes < bytes_until_sample_)
+        {
+            bytes_until_sample_ -= bytes;
+            return false;
+        }
+        bytes_until_sample_ = next_interval();
+        return true;
+    }
+
+    // caller - адрес возврата в код, вызвавший аллокатор; кадры стека до него
+    // (внутренности ресурса) не входят в ключ места вызова
+    void record(const void *p, std::size_t bytes, const void *caller = nullptr);
+    void release(const void *p);
+
+    std::vector<SiteStats> snapshot() const;
+    void dump(std::ostream &os = std::cout) const;
+
+    std::size_t sample_interval() const { return sample_interval_; }
+    std::size_t live_samples() const { return live_.size(); }
+
+private:
+    struct LiveSample
+    {
+        std::size_t site;
+        double weight;
+    };
+
+    struct Site
+    {
+        std::string name;
+        std::vector<void *> frames;
+        std::size_t live_samples = 0;
+        double live_bytes = 0.0;
+        std::size_t total_samples = 0;
+    };
+
+    std::size_t next_interval();
+    std::size_t find_or_add_site(const void *caller);
+
+    std::size_t sample_interval_;
+    std::size_t bytes_until_sample_;
+    std::mt19937_64 rng_;
+
+    std::vector<Site> sites_;
+    std::unordered_map<std::string, std::size_t> site_index_;
+    std::unordered_map<const void *, LiveSample> live_;
+};
+
+// Задает тег места вызова для аллокаций в текущем потоке на время жизни объекта
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *tag);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+    static const char *current();
+
+private:
+    const char *previous_;
+};
+
+#endif // ALLOCATION_PROFILER_H
\ No newline at end of file
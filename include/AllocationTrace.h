@@ -0,0 +1,81 @@
+#ifndef ALLOCATION_TRACE_H
+#define ALLOCATION_TRACE_H
+
+#include <memory_resource>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Двоичный формат трассы аллокаций:
+//   заголовок: 8 байт "PMRTRACE", uint32 версия, uint32 число записей
+//   далее записи TraceRecord подряд
+// Числа пишутся в порядке байт машины, записавшей трассу; трасса с другим
+// порядком байт отвергается при чтении по несовпадению версии.
+
+enum class TraceOp : std::uint8_t
+{
+    Allocate = 0,
+    Deallocate = 1
+};
+
+struct TraceRecord
+{
+    std::uint64_t timestamp_ns;  // от начала записи трассы
+    std::uint64_t id;            // порядковый номер аллокации; у освобождения - тот же
+    std::uint32_t size;          // не больше UINT32_MAX, см. kTraceSizeClamped
+    TraceOp op;
+    std::uint8_t alignment_log2;
+    std::uint8_t flags;
+    std::uint8_t reserved;
+};
+
+// Флаг TraceRecord::flags: реальный размер не поместился в 32 бита,
+// в size записан UINT32_MAX
+constexpr std::uint8_t kTraceSizeClamped = 0x01;
+
+// Наибольшее выравнивание, которое принимает load_trace (1 ГиБ)
+constexpr std::uint8_t kMaxTraceAlignmentLog2 = 30;
+
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord must stay compact");
+
+void save_trace(const std::string &path, const std::vector<TraceRecord> &records);
+// Проверяет записи: id меньше числа записей, каждый id выделяется один раз,
+// освобождается только живой блок, выравнивание не больше 2^kMaxTraceAlignmentLog2.
+// На испорченной трассе бросает std::runtime_error.
+std::vector<TraceRecord> load_trace(const std::string &path);
+
+// Обертка над любым memory_resource, записывающая каждую операцию.
+// Записи копятся в памяти и сбрасываются в файл через save().
+class TracingMemoryResource : public std::pmr::memory_resource
+{
+public:
+    explicit TracingMemoryResource(std::pmr::memory_resource *upstream,
+                                   std::size_t expected_records = 4096);
+
+    TracingMemoryResource(const TracingMemoryResource &) = delete;
+    TracingMemoryResource &operator=(const TracingMemoryResource &) = delete;
+
+    const std::vector<TraceRecord> &records() const { return records_; }
+    void save(const std::string &path) const { save_trace(path, records_); }
+
+    std::pmr::memory_resource *upstream_resource() const { return upstream_; }
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+private:
+    void record(TraceOp op, std::uint64_t id, std::size_t bytes, std::size_t alignment);
+
+    std::pmr::memory_resource *upstream_;
+    std::vector<TraceRecord> records_;
+    std::unordered_map<void *, std::uint64_t> live_ids_;
+    std::uint64_t next_id_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#endif // ALLOCATION_TRACE_H
\ No newline at end of file
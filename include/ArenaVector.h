@@ -0,0 +1,224 @@
+#ifndef ARENA_VECTOR_H
+#define ARENA_VECTOR_H
+
+#include "MemoryResource.h"
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Динамический массив поверх BasicMemoryResource. При росте сначала пытается
+// расширить текущий блок на месте (try_expand) и только потом переезжает
+// в новый блок. shrink_to_fit возвращает хвост арене без копирования.
+template <typename T, typename Resource = MemoryResource>
+class ArenaVector
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    explicit ArenaVector(Resource *mr) : mr_(mr), data_(nullptr), size_(0), capacity_(0) {}
+
+    ~ArenaVector()
+    {
+        clear();
+        release();
+    }
+
+    ArenaVector(const ArenaVector &) = delete;
+    ArenaVector &operator=(const ArenaVector &) = delete;
+
+    ArenaVector(ArenaVector &&other) noexcept
+        : mr_(other.mr_), data_(other.data_), size_(other.size_), capacity_(other.capacity_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+
+    ArenaVector &operator=(ArenaVector &&other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            release();
+
+            mr_ = other.mr_;
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.capacity_ = 0;
+        }
+        return *this;
+    }
+
+    template <typename U>
+    void push_back(U &&value)
+    {
+        emplace_back(std::forward<U>(value));
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        size_type new_capacity = capacity_ ? capacity_ * 2 : 4;
+        if (size_ < capacity_ ||
+            (data_ && mr_->try_expand(data_, capacity_ * sizeof(T), new_capacity * sizeof(T))))
+        {
+            if (size_ == capacity_)
+                capacity_ = new_capacity;
+            T *slot = ::new (static_cast<void *>(data_ + size_)) T(std::forward<Args>(args)...);
+            size_++;
+            return *slot;
+        }
+
+        // Аргумент может ссылаться на элемент этого же вектора, поэтому новый
+        // элемент строится до переезда старых, пока они еще живы
+        T *fresh = static_cast<T *>(mr_->allocate(new_capacity * sizeof(T), alignof(T)));
+        T *slot;
+        try
+        {
+            slot = ::new (static_cast<void *>(fresh + size_)) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            mr_->deallocate(fresh, new_capacity * sizeof(T), alignof(T));
+            throw;
+        }
+
+        try
+        {
+            relocate_to(fresh);
+        }
+        catch (...)
+        {
+            slot->~T();
+            mr_->deallocate(fresh, new_capacity * sizeof(T), alignof(T));
+            throw;
+        }
+
+        adopt(fresh, new_capacity);
+        size_++;
+        return *slot;
+    }
+
+    void pop_back()
+    {
+        if (size_ == 0) return;
+        data_[--size_].~T();
+    }
+
+    void reserve(size_type new_capacity)
+    {
+        if (new_capacity <= capacity_)
+            return;
+
+        if (data_ && mr_->try_expand(data_, capacity_ * sizeof(T), new_capacity * sizeof(T)))
+        {
+            capacity_ = new_capacity;
+            return;
+        }
+
+        T *fresh = static_cast<T *>(mr_->allocate(new_capacity * sizeof(T), alignof(T)));
+        try
+        {
+            relocate_to(fresh);
+        }
+        catch (...)
+        {
+            mr_->deallocate(fresh, new_capacity * sizeof(T), alignof(T));
+            throw;
+        }
+        adopt(fresh, new_capacity);
+    }
+
+    void shrink_to_fit()
+    {
+        if (!data_ || size_ == capacity_)
+            return;
+
+        if (size_ == 0)
+        {
+            release();
+            return;
+        }
+
+        if (mr_->shrink_in_place(data_, capacity_ * sizeof(T), size_ * sizeof(T)))
+            capacity_ = size_;
+    }
+
+    void clear()
+    {
+        for (size_type i = 0; i < size_; ++i)
+            data_[i].~T();
+        size_ = 0;
+    }
+
+    T &operator[](size_type i) { return data_[i]; }
+    const T &operator[](size_type i) const { return data_[i]; }
+
+    T &back() { return data_[size_ - 1]; }
+    const T &back() const { return data_[size_ - 1]; }
+
+    T *data() { return data_; }
+    const T *data() const { return data_; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+
+    Resource *get_memory_resource() const { return mr_; }
+
+private:
+    // Строит копии (или перемещенные) элементов в fresh. Старые элементы не
+    // трогаются: при исключении уже построенные уничтожаются, вектор прежний.
+    void relocate_to(T *fresh)
+    {
+        size_type built = 0;
+        try
+        {
+            for (; built < size_; ++built)
+                ::new (static_cast<void *>(fresh + built)) T(std::move_if_noexcept(data_[built]));
+        }
+        catch (...)
+        {
+            for (size_type i = 0; i < built; ++i)
+                fresh[i].~T();
+            throw;
+        }
+    }
+
+    // Вызывается после успешного relocate_to: старые элементы и блок больше не нужны
+    void adopt(T *fresh, size_type new_capacity)
+    {
+        for (size_type i = 0; i < size_; ++i)
+            data_[i].~T();
+        release();
+        data_ = fresh;
+        capacity_ = new_capacity;
+    }
+
+    void release()
+    {
+        if (data_)
+            mr_->deallocate(data_, capacity_ * sizeof(T), alignof(T));
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+
+    Resource *mr_;
+    T *data_;
+    size_type size_;
+    size_type capacity_;
+};
+
+#endif // ARENA_VECTOR_H
\ No newline at end of file
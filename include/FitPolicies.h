@@ -0,0 +1,140 @@
+#ifndef FIT_POLICIES_H
+#define FIT_POLICIES_H
+
+#include <array>
+#include <map>
+#include <cstddef>
+
+// Стратегии размещения для BasicMemoryResource.
+//
+// Каждая стратегия выбирает блок из карты свободных блоков (адрес -> BlockInfo,
+// упорядочена по адресу) и получает уведомления о появлении/исчезновении
+// свободных блоков. Выбор стратегии происходит на этапе компиляции.
+//
+// Требования к стратегии:
+//   template <typename FreeMap>
+//   typename FreeMap::iterator find(FreeMap &free_blocks, std::size_t required);
+//   void on_insert(void *addr, std::size_t size);
+//   void on_erase(void *addr, std::size_t size);
+//   static constexpr const char *name;
+
+// Первый подходящий блок по возрастанию адреса
+struct FirstFit
+{
+    static constexpr const char *name = "first-fit";
+
+    template <typename FreeMap>
+    typename FreeMap::iterator find(FreeMap &free_blocks, std::size_t required)
+    {
+        for (auto it = free_blocks.begin(); it != free_blocks.end(); ++it)
+        {
+            if (it->second.size >= required)
+                return it;
+        }
+        return free_blocks.end();
+    }
+
+    void on_insert(void *, std::size_t) {}
+    void on_erase(void *, std::size_t) {}
+};
+
+// Первый подходящий блок, начиная с места последней аллокации
+struct NextFit
+{
+    static constexpr const char *name = "next-fit";
+
+    template <typename FreeMap>
+    typename FreeMap::iterator find(FreeMap &free_blocks, std::size_t required)
+    {
+        // Храним адрес, а не итератор: итераторы инвалидируются при erase
+        auto start = free_blocks.lower_bound(rover_);
+        for (auto it = start; it != free_blocks.end(); ++it)
+        {
+            if (it->second.size >= required)
+                return remember(it);
+        }
+        for (auto it = free_blocks.begin(); it != start; ++it)
+        {
+            if (it->second.size >= required)
+                return remember(it);
+        }
+        return free_blocks.end();
+    }
+
+    void on_insert(void *, std::size_t) {}
+    void on_erase(void *, std::size_t) {}
+
+private:
+    template <typename It>
+    It remember(It it)
+    {
+        rover_ = it->first;
+        return it;
+    }
+
+    void *rover_ = nullptr;
+};
+
+// Наименьший подходящий блок
+struct BestFit
+{
+    static constexpr const char *name = "best-fit";
+
+    template <typename FreeMap>
+    typename FreeMap::iterator find(FreeMap &free_blocks, std::size_t required)
+    {
+        auto best = free_blocks.end();
+        for (auto it = free_blocks.begin(); it != free_blocks.end(); ++it)
+        {
+            if (it->second.size < required)
+                continue;
+            if (it->second.size == required)
+                return it;
+            if (best == free_blocks.end() || it->second.size < best->second.size)
+                best = it;
+        }
+        return best;
+    }
+
+    void on_insert(void *, std::size_t) {}
+    void on_erase(void *, std::size_t) {}
+};
+
+// Раздельные списки свободных блоков по классам размеров (степени двойки)
+struct SegregatedFit
+{
+    static constexpr const char *name = "segregated";
+
+    template <typename FreeMap>
+    typename FreeMap::iterator find(FreeMap &free_blocks, std::size_t required)
+    {
+        for (std::size_t c = size_class(required); c < kClasses; ++c)
+        {
+            // В старших классах любой блок подходит, в своем нужно проверять
+            for (const auto &[addr, size] : classes_[c])
+            {
+                if (size >= required)
+                    return free_blocks.find(addr);
+            }
+        }
+        return free_blocks.end();
+    }
+
+    void on_insert(void *addr, std::size_t size) { classes_[size_class(size)][addr] = size; }
+    void on_erase(void *addr, std::size_t size) { classes_[size_class(size)].erase(addr); }
+
+private:
+    static constexpr std::size_t kClasses = sizeof(std::size_t) * 8;
+
+    static std::size_t size_class(std::size_t size)
+    {
+        std::size_t c = 0;
+        while (size >>= 1)
+            ++c;
+        return c;
+    }
+
+    std::array<std::map<void *, std::size_t>, kClasses> classes_;
+};
+
+#endif // FIT_POLICIES_H
\ No newline at end of file
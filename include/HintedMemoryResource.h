@@ -0,0 +1,29 @@
+#ifndef HINTED_MEMORY_RESOURCE_H
+#define HINTED_MEMORY_RESOURCE_H
+
+#include <memory_resource>
+#include <new>
+#include <cstddef>
+
+// memory_resource, умеющий размещать блок рядом с указанным адресом.
+// Контейнеры передают адрес соседнего узла, чтобы порядок обхода
+// совпадал с порядком в памяти.
+class HintedMemoryResource : public std::pmr::memory_resource
+{
+public:
+    // hint == nullptr означает обычную аллокацию.
+    // При нехватке памяти возвращает nullptr, а не бросает std::bad_alloc.
+    virtual void *try_allocate_near(const void *hint, std::size_t bytes,
+                                    std::size_t alignment = alignof(std::max_align_t)) = 0;
+
+    void *allocate_near(const void *hint, std::size_t bytes,
+                        std::size_t alignment = alignof(std::max_align_t))
+    {
+        void *p = try_allocate_near(hint, bytes, alignment);
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+};
+
+#endif // HINTED_MEMORY_RESOURCE_H
\ No newline at end of file
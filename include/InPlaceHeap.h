@@ -0,0 +1,57 @@
+#ifndef IN_PLACE_HEAP_H
+#define IN_PLACE_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Куча, вся служебная информация которой лежит внутри управляемой памяти:
+// перед каждым блоком заголовок, свободные блоки связаны в упорядоченный
+// по смещению список. Ссылки - смещения от base, поэтому память можно
+// разделять между процессами. Никаких обращений к глобальной куче.
+//
+// InPlaceHeap - легковесное представление (base, State); само состояние
+// хранит владелец памяти. base должен быть выровнен на alignment().
+class InPlaceHeap
+{
+public:
+    static constexpr std::uint64_t npos = UINT64_MAX;
+
+    struct State
+    {
+        std::uint64_t free_head;        // первый свободный блок или npos
+        std::uint64_t allocated_blocks;
+    };
+
+    InPlaceHeap(void *base, State *state) : base_(static_cast<char *>(base)), state_(state) {}
+
+    // Размечает [base + first, base + end) как один свободный блок
+    void format(std::size_t first, std::size_t end);
+
+    // nullptr, если места нет или alignment больше alignment()
+    void *allocate(std::size_t bytes, std::size_t alignment);
+    void deallocate(void *p);
+
+    std::size_t allocated_blocks() const { return static_cast<std::size_t>(state_->allocated_blocks); }
+
+    static constexpr std::size_t alignment() { return alignof(std::max_align_t); }
+
+    // Меньше этого format() не создает ни одного свободного блока
+    static constexpr std::size_t min_block_size() { return 2 * sizeof(BlockHeader); }
+
+private:
+    struct BlockHeader
+    {
+        std::uint64_t size;             // включая заголовок
+        std::uint64_t next_free;
+    };
+
+    BlockHeader *block_at(std::uint64_t offset) const
+    {
+        return reinterpret_cast<BlockHeader *>(base_ + offset);
+    }
+
+    char *base_;
+    State *state_;
+};
+
+#endif // IN_PLACE_HEAP_H
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef INLINE_MEMORY_RESOURCE_H
+#define INLINE_MEMORY_RESOURCE_H
+
+#include "HintedMemoryResource.h"
+#include "InPlaceHeap.h"
+#include <memory_resource>
+#include <cstddef>
+#include <new>
+
+// Арена из N байт внутри самого объекта: может жить на стеке, и ни
+// конструктор, ни учет блоков не обращаются к глобальной куче. Когда арена
+// заполнена, аллокации уходят в upstream; без upstream бросается
+// std::bad_alloc (try_allocate_near возвращает nullptr).
+template <std::size_t N>
+class InlineMemoryResource : public HintedMemoryResource
+{
+public:
+    explicit InlineMemoryResource(std::pmr::memory_resource *upstream = nullptr)
+        : upstream_(upstream), hinted_upstream_(dynamic_cast<HintedMemoryResource *>(upstream))
+    {
+        heap().format(0, N);
+    }
+
+    InlineMemoryResource(const InlineMemoryResource &) = delete;
+    InlineMemoryResource &operator=(const InlineMemoryResource &) = delete;
+
+    // Подсказка учитывается только при переходе в upstream
+    void *try_allocate_near(const void *hint, std::size_t bytes,
+                            std::size_t alignment = alignof(std::max_align_t)) override
+    {
+        if (void *p = heap().allocate(bytes, alignment))
+            return p;
+
+        if (hinted_upstream_)
+            return count_upstream(hinted_upstream_->try_allocate_near(hint, bytes, alignment));
+
+        if (!upstream_)
+            return nullptr;
+
+        try
+        {
+            return count_upstream(upstream_->allocate(bytes, alignment));
+        }
+        catch (const std::bad_alloc &)
+        {
+            return nullptr;
+        }
+    }
+
+    bool owns(const void *p) const
+    {
+        const unsigned char *c = static_cast<const unsigned char *>(p);
+        return c >= buffer_ && c < buffer_ + N;
+    }
+
+    std::pmr::memory_resource *upstream_resource() const { return upstream_; }
+    std::size_t inline_blocks() const { return heap().allocated_blocks(); }
+    std::size_t upstream_allocations() const { return upstream_allocations_; }
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (void *p = heap().allocate(bytes, alignment))
+            return p;
+
+        if (!upstream_)
+            throw std::bad_alloc();
+        return count_upstream(upstream_->allocate(bytes, alignment));
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+    {
+        if (owns(p))
+            heap().deallocate(p);
+        else
+            upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    InPlaceHeap heap() const
+    {
+        return InPlaceHeap(const_cast<unsigned char *>(buffer_), &state_);
+    }
+
+    void *count_upstream(void *p)
+    {
+        if (p)
+            upstream_allocations_++;
+        return p;
+    }
+
+    alignas(std::max_align_t) unsigned char buffer_[N];
+    mutable InPlaceHeap::State state_;
+    std::pmr::memory_resource *upstream_;
+    HintedMemoryResource *hinted_upstream_;
+    std::size_t upstream_allocations_ = 0;
+};
+
+#endif // INLINE_MEMORY_RESOURCE_H
\ No newline at end of file
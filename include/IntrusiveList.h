@@ -0,0 +1,246 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#include <iterator>
+#include <cstddef>
+
+// Хук для IntrusiveList: элемент наследует IntrusiveListHook<Tag> и сам
+// хранит связи, поэтому список не выделяет память и не копирует элементы.
+// Tag позволяет одному объекту состоять в нескольких списках одновременно.
+//
+// unlink() удаляет элемент из списка за O(1) без ссылки на сам список;
+// деструктор хука делает это автоматически.
+template <typename Tag = void>
+class IntrusiveListHook
+{
+public:
+    IntrusiveListHook() : prev_(nullptr), next_(nullptr) {}
+
+    // Копия объекта не состоит в списке оригинала
+    IntrusiveListHook(const IntrusiveListHook &) : prev_(nullptr), next_(nullptr) {}
+    IntrusiveListHook &operator=(const IntrusiveListHook &) { return *this; }
+
+    ~IntrusiveListHook() { unlink(); }
+
+    bool is_linked() const { return next_ != nullptr; }
+
+    void unlink()
+    {
+        if (!next_)
+            return;
+        prev_->next_ = next_;
+        next_->prev_ = prev_;
+        prev_ = next_ = nullptr;
+    }
+
+private:
+    template <typename, typename>
+    friend class IntrusiveList;
+
+    // Вставка перед pos
+    void link_before(IntrusiveListHook *pos)
+    {
+        prev_ = pos->prev_;
+        next_ = pos;
+        pos->prev_->next_ = this;
+        pos->prev_ = this;
+    }
+
+    IntrusiveListHook *prev_;
+    IntrusiveListHook *next_;
+};
+
+// Двусвязный список над объектами, которыми владеет кто-то другой.
+// Внутри - кольцо со служебным узлом, поэтому вставка и удаление не
+// проверяют граничные случаи. Элемент должен пережить свое пребывание в
+// списке (или удалиться сам через unlink()).
+//
+// Так как элементы могут удаляться сами, размер не хранится: size() - O(n),
+// empty() - O(1).
+template <typename T, typename Tag = void>
+class IntrusiveList
+{
+private:
+    using Hook = IntrusiveListHook<Tag>;
+
+    static T *value_of(Hook *h) { return static_cast<T *>(h); }
+    static const T *value_of(const Hook *h) { return static_cast<const T *>(h); }
+    static Hook *hook_of(T &value) { return static_cast<Hook *>(&value); }
+
+public:
+    struct iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+        Hook *node;
+        iterator(Hook *n = nullptr) : node(n) {}
+
+        reference operator*() const { return *value_of(node); }
+        pointer operator->() const { return value_of(node); }
+
+        iterator &operator++()
+        {
+            if (node)
+                node = node->next_;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const { return node == other.node; }
+        bool operator!=(const iterator &other) const { return node != other.node; }
+    };
+
+    struct const_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = const T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const Hook *node;
+        const_iterator(const Hook *n = nullptr) : node(n) {}
+        const_iterator(const iterator &it) : node(it.node) {}
+
+        reference operator*() const { return *value_of(node); }
+        pointer operator->() const { return value_of(node); }
+
+        const_iterator &operator++()
+        {
+            if (node)
+                node = node->next_;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const const_iterator &other) const { return node == other.node; }
+        bool operator!=(const const_iterator &other) const { return node != other.node; }
+    };
+
+    IntrusiveList() { reset(); }
+
+    ~IntrusiveList() { clear(); }
+
+    IntrusiveList(const IntrusiveList &) = delete;
+    IntrusiveList &operator=(const IntrusiveList &) = delete;
+
+    IntrusiveList(IntrusiveList &&other) noexcept
+    {
+        reset();
+        take(other);
+    }
+
+    IntrusiveList &operator=(IntrusiveList &&other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    // Элемент не должен уже состоять в списке с тем же Tag
+    void push_back(T &value) { hook_of(value)->link_before(&sentinel_); }
+    void push_front(T &value) { hook_of(value)->link_before(sentinel_.next_); }
+
+    iterator insert(iterator pos, T &value)
+    {
+        hook_of(value)->link_before(pos.node);
+        return iterator(hook_of(value));
+    }
+
+    iterator erase(iterator pos)
+    {
+        if (pos == end()) return end();
+
+        Hook *next_node = pos.node->next_;
+        pos.node->unlink();
+        return iterator(next_node);
+    }
+
+    // O(1): удаление по ссылке на элемент
+    void erase(T &value) { hook_of(value)->unlink(); }
+
+    void pop_front()
+    {
+        if (!empty())
+            sentinel_.next_->unlink();
+    }
+
+    void pop_back()
+    {
+        if (!empty())
+            sentinel_.prev_->unlink();
+    }
+
+    void clear()
+    {
+        while (!empty())
+            sentinel_.next_->unlink();
+    }
+
+    // Итератор на элемент, уже состоящий в этом списке
+    iterator iterator_to(T &value) { return iterator(hook_of(value)); }
+
+    T& front() { return *value_of(sentinel_.next_); }
+    const T& front() const { return *value_of(sentinel_.next_); }
+
+    T& back() { return *value_of(sentinel_.prev_); }
+    const T& back() const { return *value_of(sentinel_.prev_); }
+
+    iterator begin() { return iterator(sentinel_.next_); }
+    iterator end() { return iterator(&sentinel_); }
+
+    const_iterator begin() const { return const_iterator(sentinel_.next_); }
+    const_iterator end() const { return const_iterator(&sentinel_); }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return sentinel_.next_ == &sentinel_; }
+
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+        for (const Hook *h = sentinel_.next_; h != &sentinel_; h = h->next_)
+            ++n;
+        return n;
+    }
+
+private:
+    void reset() { sentinel_.prev_ = sentinel_.next_ = &sentinel_; }
+
+    // Переносит кольцо other на наш служебный узел
+    void take(IntrusiveList &other)
+    {
+        if (other.empty())
+            return;
+
+        sentinel_.next_ = other.sentinel_.next_;
+        sentinel_.prev_ = other.sentinel_.prev_;
+        sentinel_.next_->prev_ = &sentinel_;
+        sentinel_.prev_->next_ = &sentinel_;
+        other.reset();
+    }
+
+    Hook sentinel_;
+};
+
+#endif // INTRUSIVE_LIST_H
\ No newline at end of file
@@ -1,7 +1,9 @@
 #ifndef LIST_H
 #define LIST_H
 
+#include "HintedMemoryResource.h"
 #include <memory_resource>
+#include <new>
 #include <iterator>
 #include <utility>
 #include <cstddef>
@@ -90,7 +92,8 @@ public:
     using allocator_type = std::pmr::polymorphic_allocator<Node>;
 
     explicit DoublyLinkedList(std::pmr::memory_resource *mr = std::pmr::get_default_resource())
-        : alloc_(mr), head_(nullptr), tail_(nullptr), size_(0) {}
+        : alloc_(mr), hinted_(dynamic_cast<HintedMemoryResource *>(mr)),
+          head_(nullptr), tail_(nullptr), size_(0) {}
 
     ~DoublyLinkedList() { clear(); }
     
@@ -98,7 +101,8 @@ public:
     DoublyLinkedList &operator=(const DoublyLinkedList &) = delete;
 
     DoublyLinkedList(DoublyLinkedList &&other) noexcept
-        : alloc_(other.alloc_), head_(other.head_), tail_(other.tail_), size_(other.size_)
+        : alloc_(other.alloc_), hinted_(other.hinted_),
+          head_(other.head_), tail_(other.tail_), size_(other.size_)
     {
         other.head_ = nullptr;
         other.tail_ = nullptr;
@@ -127,31 +131,13 @@ public:
     template <typename U>
     void push_back(U &&value)
     {
-        Node *n = allocate_node(std::forward<U>(value));
-        if (!tail_)
-            head_ = tail_ = n;
-        else
-        {
-            tail_->next = n;
-            n->prev = tail_;
-            tail_ = n;
-        }
-        size_++;
+        link_back(allocate_node(tail_, std::forward<U>(value)));
     }
 
     template <typename U>
     void push_front(U &&value)
     {
-        Node *n = allocate_node(std::forward<U>(value));
-        if (!head_)
-            head_ = tail_ = n;
-        else
-        {
-            n->next = head_;
-            head_->prev = n;
-            head_ = n;
-        }
-        size_++;
+        link_front(allocate_node(head_, std::forward<U>(value)));
     }
 
     iterator insert(iterator pos, const T& value)
@@ -162,20 +148,47 @@ public:
             return iterator(tail_);
         }
         
-        Node *n = allocate_node(value);
-        Node *curr = pos.node;
-        
-        n->prev = curr->prev;
-        n->next = curr;
-        
-        if (curr->prev)
-            curr->prev->next = n;
+        Node *n = allocate_node(pos.node, value);
+        link_before(pos.node, n);
+        return iterator(n);
+    }
+
+    // Варианты без исключений при нехватке памяти: результат сообщает,
+    // удалось ли выделить узел. Исключения из конструктора T не перехватываются.
+    // С HintedMemoryResource исключения не возникают вовсе, с прочими
+    // ресурсами std::bad_alloc перехватывается внутри.
+    template <typename U>
+    bool try_push_back(U &&value)
+    {
+        Node *n = try_allocate_node(tail_, std::forward<U>(value));
+        if (!n)
+            return false;
+        link_back(n);
+        return true;
+    }
+
+    template <typename U>
+    bool try_push_front(U &&value)
+    {
+        Node *n = try_allocate_node(head_, std::forward<U>(value));
+        if (!n)
+            return false;
+        link_front(n);
+        return true;
+    }
+
+    // Конструирует элемент перед pos; при нехватке памяти возвращает end()
+    template <typename... Args>
+    iterator try_emplace(iterator pos, Args &&...args)
+    {
+        Node *n = try_allocate_node(pos.node ? pos.node : tail_, std::forward<Args>(args)...);
+        if (!n)
+            return end();
+
+        if (pos == end())
+            link_back(n);
         else
-            head_ = n;
-            
-        curr->prev = n;
-        size_++;
-        
+            link_before(pos.node, n);
         return iterator(n);
     }
 
@@ -186,22 +199,29 @@ public:
         Node *curr = pos.node;
         Node *next_node = curr->next;
         
-        if (curr->prev)
-            curr->prev->next = curr->next;
-        else
-            head_ = curr->next;
-            
-        if (curr->next)
-            curr->next->prev = curr->prev;
-        else
-            tail_ = curr->prev;
-            
+        unlink(curr);
         destroy_node(curr);
-        size_--;
         
         return iterator(next_node);
     }
 
+    // Переносит узел it из other (или из этого же списка) перед pos без
+    // аллокаций и копирования. Списки должны использовать один memory_resource.
+    void splice(iterator pos, DoublyLinkedList &other, iterator it)
+    {
+        Node *n = it.node;
+        if (!n || n == pos.node)
+            return;
+
+        other.unlink(n);
+        n->prev = n->next = nullptr;
+
+        if (pos == end())
+            link_back(n);
+        else
+            link_before(pos.node, n);
+    }
+
     void pop_front()
     {
         erase(begin());
@@ -252,13 +272,102 @@ public:
     }
 
 private:
-    template <typename U>
-    Node *allocate_node(U &&value)
+    void unlink(Node *curr)
+    {
+        if (curr->prev)
+            curr->prev->next = curr->next;
+        else
+            head_ = curr->next;
+            
+        if (curr->next)
+            curr->next->prev = curr->prev;
+        else
+            tail_ = curr->prev;
+            
+        size_--;
+    }
+
+    void link_back(Node *n)
+    {
+        if (!tail_)
+            head_ = tail_ = n;
+        else
+        {
+            tail_->next = n;
+            n->prev = tail_;
+            tail_ = n;
+        }
+        size_++;
+    }
+
+    void link_front(Node *n)
+    {
+        if (!head_)
+            head_ = tail_ = n;
+        else
+        {
+            n->next = head_;
+            head_->prev = n;
+            head_ = n;
+        }
+        size_++;
+    }
+
+    void link_before(Node *curr, Node *n)
+    {
+        n->prev = curr->prev;
+        n->next = curr;
+        
+        if (curr->prev)
+            curr->prev->next = n;
+        else
+            head_ = n;
+            
+        curr->prev = n;
+        size_++;
+    }
+
+    // hint - соседний узел, рядом с которым желательно разместить новый
+    template <typename... Args>
+    Node *allocate_node(const Node *hint, Args &&...args)
+    {
+        Node *p = hinted_
+            ? static_cast<Node *>(hinted_->allocate_near(hint, sizeof(Node), alignof(Node)))
+            : alloc_.allocate(1);
+        return construct_node(p, std::forward<Args>(args)...);
+    }
+
+    // Возвращает nullptr, если память закончилась
+    template <typename... Args>
+    Node *try_allocate_node(const Node *hint, Args &&...args)
+    {
+        Node *p = nullptr;
+        if (hinted_)
+        {
+            p = static_cast<Node *>(hinted_->try_allocate_near(hint, sizeof(Node), alignof(Node)));
+        }
+        else
+        {
+            try
+            {
+                p = alloc_.allocate(1);
+            }
+            catch (const std::bad_alloc &)
+            {
+                return nullptr;
+            }
+        }
+        if (!p)
+            return nullptr;
+        return construct_node(p, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    Node *construct_node(Node *p, Args &&...args)
     {
-        Node *p = alloc_.allocate(1);
         try
         {
-            std::allocator_traits<allocator_type>::construct(alloc_, p, std::forward<U>(value));
+            std::allocator_traits<allocator_type>::construct(alloc_, p, std::forward<Args>(args)...);
         }
         catch (...)
         {
@@ -275,6 +384,7 @@ private:
     }
 
     allocator_type alloc_;
+    HintedMemoryResource *hinted_; // nullptr, если ресурс не поддерживает подсказки
     Node *head_;
     Node *tail_;
     std::size_t size_;
@@ -0,0 +1,182 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include "List.h"
+#include <memory_resource>
+#include <unordered_map>
+#include <functional>
+#include <stdexcept>
+#include <cstddef>
+#include <utility>
+
+enum class CacheMode
+{
+    Lru,          // один список по давности использования
+    SegmentedLru  // испытательный и защищенный сегменты (SLRU)
+};
+
+// Кэш фиксированной емкости. Узлы списка давности и узлы/бакеты хеш-индекса
+// размещаются в одном memory_resource. get/put/вытеснение - O(1), перемещение
+// в начало делается перевязкой узла без аллокаций.
+//
+// В режиме SegmentedLru новый ключ попадает в испытательный сегмент и
+// переходит в защищенный (80% емкости) при повторном обращении. Вытесняется
+// хвост испытательного сегмента, поэтому однократные обращения не
+// вымывают часто используемые ключи.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class LruCache
+{
+private:
+    struct Entry
+    {
+        K key;
+        V value;
+        bool is_protected;
+
+        template <typename KK, typename VV>
+        Entry(KK &&k, VV &&v)
+            : key(std::forward<KK>(k)), value(std::forward<VV>(v)), is_protected(false) {}
+    };
+
+    using List = DoublyLinkedList<Entry>;
+    using Index = std::pmr::unordered_map<K, typename List::iterator, Hash, KeyEqual>;
+
+public:
+    LruCache(std::size_t capacity, std::pmr::memory_resource *mr = std::pmr::get_default_resource(),
+             CacheMode mode = CacheMode::Lru)
+        : capacity_(capacity),
+          protected_capacity_(mode == CacheMode::SegmentedLru ? capacity * 4 / 5 : 0),
+          mode_(mode), probation_(mr), protected_(mr), index_(mr)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("LruCache capacity must be positive");
+
+        // Бакеты выделяются один раз, чтобы не было рехеширования в работе
+        index_.reserve(capacity);
+    }
+
+    LruCache(const LruCache &) = delete;
+    LruCache &operator=(const LruCache &) = delete;
+
+    // Возвращает nullptr при промахе; при попадании ключ становится самым свежим
+    V *get(const K &key)
+    {
+        auto found = index_.find(key);
+        if (found == index_.end())
+        {
+            misses_++;
+            return nullptr;
+        }
+
+        hits_++;
+        touch(found->second);
+        return &found->second->value;
+    }
+
+    // Проверка наличия без изменения порядка
+    bool contains(const K &key) const { return index_.count(key) != 0; }
+
+    template <typename KK, typename VV>
+    void put(KK &&key, VV &&value)
+    {
+        auto found = index_.find(key);
+        if (found != index_.end())
+        {
+            found->second->value = std::forward<VV>(value);
+            touch(found->second);
+            return;
+        }
+
+        if (size() == capacity_)
+            evict();
+
+        probation_.push_front(Entry(std::forward<KK>(key), std::forward<VV>(value)));
+        try
+        {
+            index_.emplace(probation_.front().key, probation_.begin());
+        }
+        catch (...)
+        {
+            // Узел индекса живет в той же арене; без отката в списке остался бы
+            // ключ, недоступный через индекс
+            probation_.pop_front();
+            throw;
+        }
+    }
+
+    bool erase(const K &key)
+    {
+        auto found = index_.find(key);
+        if (found == index_.end())
+            return false;
+
+        auto it = found->second;
+        index_.erase(found);
+        segment_of(*it).erase(it);
+        return true;
+    }
+
+    void clear()
+    {
+        index_.clear();
+        probation_.clear();
+        protected_.clear();
+    }
+
+    std::size_t size() const { return probation_.size() + protected_.size(); }
+    std::size_t capacity() const { return capacity_; }
+    bool empty() const { return size() == 0; }
+    CacheMode mode() const { return mode_; }
+
+    std::size_t hits() const { return hits_; }
+    std::size_t misses() const { return misses_; }
+    std::size_t evictions() const { return evictions_; }
+
+    std::pmr::memory_resource *get_memory_resource() const { return probation_.get_memory_resource(); }
+
+private:
+    List &segment_of(const Entry &e) { return e.is_protected ? protected_ : probation_; }
+
+    void touch(typename List::iterator it)
+    {
+        if (mode_ == CacheMode::Lru)
+        {
+            probation_.splice(probation_.begin(), probation_, it);
+            return;
+        }
+
+        // Повторное обращение переводит ключ в защищенный сегмент
+        List &from = segment_of(*it);
+        it->is_protected = true;
+        protected_.splice(protected_.begin(), from, it);
+
+        if (protected_.size() > protected_capacity_)
+        {
+            // Самый старый защищенный ключ возвращается в испытательный сегмент
+            auto demoted = index_.find(protected_.back().key)->second;
+            demoted->is_protected = false;
+            probation_.splice(probation_.begin(), protected_, demoted);
+        }
+    }
+
+    void evict()
+    {
+        List &victims = probation_.empty() ? protected_ : probation_;
+        index_.erase(victims.back().key);
+        victims.pop_back();
+        evictions_++;
+    }
+
+    std::size_t capacity_;
+    std::size_t protected_capacity_;
+    CacheMode mode_;
+    List probation_;  // в режиме Lru - единственный список
+    List protected_;
+    Index index_;
+
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+    std::size_t evictions_ = 0;
+};
+
+#endif // LRU_CACHE_H
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef MEMORY_RESOURCE_H
 #define MEMORY_RESOURCE_H
 
+#include "FitPolicies.h"
+#include "HintedMemoryResource.h"
 #include <memory_resource>
 #include <map>
 #include <new>
@@ -9,22 +11,75 @@
 #include <cstdint>
 #include <iostream>
 
-class MemoryResource : public std::pmr::memory_resource
+#ifdef PMR_ENABLE_PROFILER
+#include "AllocationProfiler.h"
+#endif
+
+// Арена фиксированного размера; стратегия размещения задается параметром шаблона
+template <typename FitPolicy>
+class BasicMemoryResource : public HintedMemoryResource
 {
 private:
     struct BlockInfo
     {
         std::size_t size;
         bool is_free;
+#ifdef PMR_ENABLE_PROFILER
+        bool sampled = false;
+#endif
     };
 
+    using BlockMap = std::map<void *, BlockInfo>;
+
     void *buffer_;
     std::size_t buffer_size_;
-    std::map<void *, BlockInfo> allocated_blocks_;
-    std::map<void *, BlockInfo> free_blocks_;
+    BlockMap allocated_blocks_;
+    BlockMap free_blocks_;
+    FitPolicy policy_;
+    bool verbose_ = true;
+#ifdef PMR_ENABLE_PROFILER
+    AllocationProfiler *profiler_ = nullptr;
+
+    // Адрес возврата из самого внешнего входа в арену; профилировщик отрезает
+    // по нему внутренние кадры ресурса
+    const void *caller_ = nullptr;
+
+    class CallerScope
+    {
+    public:
+        CallerScope(const void *&slot, const void *caller) : slot_(slot), owner_(slot == nullptr)
+        {
+            if (owner_)
+                slot_ = caller;
+        }
+        ~CallerScope()
+        {
+            if (owner_)
+                slot_ = nullptr;
+        }
+
+        CallerScope(const CallerScope &) = delete;
+        CallerScope &operator=(const CallerScope &) = delete;
+
+    private:
+        const void *&slot_;
+        bool owner_;
+    };
+#endif
 
     void merge_adjacent_free_blocks();
 
+    // Все изменения free_blocks_ идут через эти функции, чтобы стратегия видела их
+    void insert_free(void *p, std::size_t size);
+    typename BlockMap::iterator erase_free(typename BlockMap::iterator it);
+
+    // Выделение из начала / из конца свободного блока it
+    void *carve_front(typename BlockMap::iterator it, std::size_t bytes, std::size_t alignment);
+    void *carve_back(typename BlockMap::iterator it, std::size_t bytes, std::size_t alignment);
+
+    // Регистрирует новый занятый блок (и, если включено, отдает его профилировщику)
+    void record_allocation(void *p, std::size_t used_size, std::size_t bytes);
+
     // Вспомогательная функция для выравнивания адреса
     static void* align_pointer(void* ptr, std::size_t alignment) {
         std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
@@ -41,23 +96,55 @@ private:
     }
 
 public:
-    explicit MemoryResource(std::size_t total_size);
-    ~MemoryResource() override;
-    
-    MemoryResource(const MemoryResource &) = delete;
-    MemoryResource &operator=(const MemoryResource &) = delete;
+    using policy_type = FitPolicy;
+
+    explicit BasicMemoryResource(std::size_t total_size);
+    ~BasicMemoryResource() override;
+
+    BasicMemoryResource(const BasicMemoryResource &) = delete;
+    BasicMemoryResource &operator=(const BasicMemoryResource &) = delete;
+
+    // Включение/отключение вывода каждой операции в std::cout
+    void set_verbose(bool verbose) { verbose_ = verbose; }
+
+#ifdef PMR_ENABLE_PROFILER
+    // Выборочное профилирование аллокаций; nullptr отключает
+    void set_profiler(AllocationProfiler *profiler) { profiler_ = profiler; }
+#endif
+
+    // Как allocate(), но при нехватке памяти возвращает nullptr вместо исключения
+    void *try_allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    // Сначала ищет подходящий свободный блок рядом с hint (в обе стороны, в
+    // пределах небольшого окна), иначе выбирает блок по стратегии FitPolicy
+    void *try_allocate_near(const void *hint, std::size_t bytes,
+                            std::size_t alignment = alignof(std::max_align_t)) override;
+
+    // Расширение блока p до new_size за счет соседнего свободного блока без
+    // перемещения данных. Возвращает false, если места справа недостаточно.
+    bool try_expand(void *p, std::size_t old_size, std::size_t new_size);
+
+    // Возвращает хвост блока p после new_size байт в свободную память
+    bool shrink_in_place(void *p, std::size_t old_size, std::size_t new_size);
+
+    // Статистика для оценки фрагментации
+    std::size_t capacity() const { return buffer_size_; }
+    std::size_t free_bytes() const;
+    std::size_t largest_free_block() const;
+    std::size_t free_block_count() const { return free_blocks_.size(); }
+    std::size_t allocated_block_count() const { return allocated_blocks_.size(); }
 
     // Для отладки
     void dump() const {
-        std::cout << "=== MemoryResource Dump ===" << std::endl;
+        std::cout << "=== MemoryResource Dump (" << FitPolicy::name << ") ===" << std::endl;
         std::cout << "Total buffer size: " << buffer_size_ << " bytes" << std::endl;
         std::cout << "Buffer address: " << buffer_ << std::endl;
-        
+
         std::cout << "\nAllocated blocks (" << allocated_blocks_.size() << "):" << std::endl;
         for (const auto& [addr, info] : allocated_blocks_) {
             std::cout << "  " << addr << " - " << info.size << " bytes" << std::endl;
         }
-        
+
         std::cout << "\nFree blocks (" << free_blocks_.size() << "):" << std::endl;
         for (const auto& [addr, info] : free_blocks_) {
             std::cout << "  " << addr << " - " << info.size << " bytes" << std::endl;
@@ -71,4 +158,15 @@ protected:
     bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
 };
 
+// Реализация в MemoryResource.cpp, инстанцирована для всех стандартных стратегий
+extern template class BasicMemoryResource<FirstFit>;
+extern template class BasicMemoryResource<NextFit>;
+extern template class BasicMemoryResource<BestFit>;
+extern template class BasicMemoryResource<SegregatedFit>;
+
+using MemoryResource = BasicMemoryResource<FirstFit>;
+using NextFitMemoryResource = BasicMemoryResource<NextFit>;
+using BestFitMemoryResource = BasicMemoryResource<BestFit>;
+using SegregatedMemoryResource = BasicMemoryResource<SegregatedFit>;
+
 #endif // MEMORY_RESOURCE_H
\ No newline at end of file
@@ -0,0 +1,230 @@
+#ifndef SHARED_LIST_H
+#define SHARED_LIST_H
+
+#include "SharedMemoryResource.h"
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// Двусвязный список в сегменте SharedMemoryResource. Связи хранятся как
+// смещения внутри сегмента, поэтому список, построенный одним процессом,
+// читается другими без копирования, даже если сегмент отображен по другому
+// адресу. SharedList - лишь дескриптор: данные живут в сегменте и
+// переживают объект. Изменения из нескольких процессов одновременно не
+// синхронизируются.
+template <typename T>
+class SharedList
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SharedList elements must not own process-local memory");
+
+private:
+    struct Node
+    {
+        T value;
+        std::uint64_t prev;
+        std::uint64_t next;
+    };
+
+    struct Header
+    {
+        std::uint64_t head;
+        std::uint64_t tail;
+        std::uint64_t size;
+    };
+
+public:
+    struct iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+        const SharedMemoryResource *mr;
+        std::uint64_t offset;
+        iterator(const SharedMemoryResource *m = nullptr, std::uint64_t off = 0) : mr(m), offset(off) {}
+
+        reference operator*() const { return node()->value; }
+        pointer operator->() const { return &node()->value; }
+
+        iterator &operator++()
+        {
+            if (offset)
+                offset = node()->next;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const iterator &other) const { return offset == other.offset; }
+        bool operator!=(const iterator &other) const { return offset != other.offset; }
+
+    private:
+        Node *node() const { return static_cast<Node *>(mr->from_offset(offset)); }
+    };
+
+    struct const_iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = const T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const SharedMemoryResource *mr;
+        std::uint64_t offset;
+        const_iterator(const SharedMemoryResource *m = nullptr, std::uint64_t off = 0) : mr(m), offset(off) {}
+        const_iterator(const iterator &it) : mr(it.mr), offset(it.offset) {}
+
+        reference operator*() const { return node()->value; }
+        pointer operator->() const { return &node()->value; }
+
+        const_iterator &operator++()
+        {
+            if (offset)
+                offset = node()->next;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const const_iterator &other) const { return offset == other.offset; }
+        bool operator!=(const const_iterator &other) const { return offset != other.offset; }
+
+    private:
+        const Node *node() const { return static_cast<const Node *>(mr->from_offset(offset)); }
+    };
+
+    // Создает новый пустой список в сегменте
+    explicit SharedList(SharedMemoryResource &mr)
+        : mr_(&mr), header_(static_cast<Header *>(mr.allocate(sizeof(Header), alignof(Header))))
+    {
+        header_->head = header_->tail = header_->size = 0;
+    }
+
+    // Подключается к списку, созданному ранее (возможно, другим процессом)
+    SharedList(SharedMemoryResource &mr, std::uint64_t header_offset)
+        : mr_(&mr), header_(static_cast<Header *>(mr.from_offset(header_offset))) {}
+
+    // Смещение заголовка - по нему другие процессы находят список
+    std::uint64_t offset() const { return mr_->to_offset(header_); }
+    const void *address() const { return header_; }
+
+    void push_back(const T &value)
+    {
+        std::uint64_t n = allocate_node(value);
+        Node *node = at(n);
+        node->prev = header_->tail;
+        if (header_->tail)
+            at(header_->tail)->next = n;
+        else
+            header_->head = n;
+        header_->tail = n;
+        header_->size++;
+    }
+
+    void push_front(const T &value)
+    {
+        std::uint64_t n = allocate_node(value);
+        Node *node = at(n);
+        node->next = header_->head;
+        if (header_->head)
+            at(header_->head)->prev = n;
+        else
+            header_->tail = n;
+        header_->head = n;
+        header_->size++;
+    }
+
+    void pop_front()
+    {
+        if (header_->head)
+            erase_node(header_->head);
+    }
+
+    void pop_back()
+    {
+        if (header_->tail)
+            erase_node(header_->tail);
+    }
+
+    void clear()
+    {
+        while (header_->head)
+            erase_node(header_->head);
+    }
+
+    // Освобождает элементы и заголовок; дескриптор после этого недействителен
+    void destroy()
+    {
+        clear();
+        mr_->deallocate(header_, sizeof(Header), alignof(Header));
+        header_ = nullptr;
+    }
+
+    T &front() { return at(header_->head)->value; }
+    const T &front() const { return at(header_->head)->value; }
+
+    T &back() { return at(header_->tail)->value; }
+    const T &back() const { return at(header_->tail)->value; }
+
+    iterator begin() { return iterator(mr_, header_->head); }
+    iterator end() { return iterator(mr_, 0); }
+
+    const_iterator begin() const { return const_iterator(mr_, header_->head); }
+    const_iterator end() const { return const_iterator(mr_, 0); }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return header_->size == 0; }
+    std::size_t size() const { return static_cast<std::size_t>(header_->size); }
+
+    SharedMemoryResource *get_memory_resource() const { return mr_; }
+
+private:
+    Node *at(std::uint64_t offset) const { return static_cast<Node *>(mr_->from_offset(offset)); }
+
+    std::uint64_t allocate_node(const T &value)
+    {
+        Node *p = static_cast<Node *>(mr_->allocate(sizeof(Node), alignof(Node)));
+        ::new (static_cast<void *>(p)) Node{value, 0, 0};
+        return mr_->to_offset(p);
+    }
+
+    void erase_node(std::uint64_t n)
+    {
+        Node *node = at(n);
+        if (node->prev)
+            at(node->prev)->next = node->next;
+        else
+            header_->head = node->next;
+
+        if (node->next)
+            at(node->next)->prev = node->prev;
+        else
+            header_->tail = node->prev;
+
+        header_->size--;
+        mr_->deallocate(node, sizeof(Node), alignof(Node));
+    }
+
+    SharedMemoryResource *mr_;
+    Header *header_;
+};
+
+#endif // SHARED_LIST_H
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef SHARED_MEMORY_RESOURCE_H
+#define SHARED_MEMORY_RESOURCE_H
+
+#include "InPlaceHeap.h"
+#include <memory_resource>
+#include <pthread.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Арена в разделяемой памяти POSIX (shm_open + mmap).
+//
+// Все служебные данные (список свободных блоков, мьютекс) лежат в самом
+// сегменте и адресуются смещениями от его начала, поэтому процессы могут
+// отображать сегмент по разным адресам. Мьютекс разделяемый между процессами
+// и устойчивый к падению владельца.
+//
+// Первый конструктор создает сегмент (и удаляет его имя в деструкторе),
+// второй подключается к существующему; total_size меньше заголовка
+// сегмента и одного блока - std::invalid_argument. Выравнивание больше
+// alignof(std::max_align_t) не поддерживается.
+class SharedMemoryResource : public std::pmr::memory_resource
+{
+public:
+    SharedMemoryResource(const std::string &name, std::size_t total_size);
+    explicit SharedMemoryResource(const std::string &name);
+    ~SharedMemoryResource() override;
+
+    SharedMemoryResource(const SharedMemoryResource &) = delete;
+    SharedMemoryResource &operator=(const SharedMemoryResource &) = delete;
+
+    // Перевод между адресами этого процесса и смещениями внутри сегмента.
+    // Смещение 0 соответствует nullptr.
+    std::uint64_t to_offset(const void *p) const;
+    void *from_offset(std::uint64_t offset) const;
+
+    // Корневой объект сегмента, через который другие процессы находят данные
+    void set_root(const void *p);
+    void *root() const;
+
+    const std::string &name() const { return name_; }
+    bool is_owner() const { return owner_; }
+    std::size_t capacity() const { return mapped_size_; }
+    std::size_t allocated_block_count() const;
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+private:
+    struct SegmentHeader;
+    class Lock;
+
+    SegmentHeader *header() const { return static_cast<SegmentHeader *>(base_); }
+    InPlaceHeap heap() const;
+
+    void map(int fd, std::size_t size);
+
+    std::string name_;
+    void *base_;
+    std::size_t mapped_size_;
+    bool owner_;
+};
+
+#endif // SHARED_MEMORY_RESOURCE_H
\ No newline at end of file
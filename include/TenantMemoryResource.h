@@ -0,0 +1,68 @@
+#ifndef TENANT_MEMORY_RESOURCE_H
+#define TENANT_MEMORY_RESOURCE_H
+
+#include "HintedMemoryResource.h"
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class QuotaMode
+{
+    Soft,  // превышение разрешено, но учитывается в quota_violations()
+    Hard   // аллокация сверх квоты отклоняется
+};
+
+// Представление родительской арены для одного владельца (например, одного
+// списка). Считает байты и блоки владельца и применяет квоту; сама память
+// выделяется родителем. Подсказки размещения передаются родителю, если он
+// их поддерживает.
+class TenantMemoryResource : public HintedMemoryResource
+{
+public:
+    TenantMemoryResource(std::pmr::memory_resource *parent, std::string name,
+                         std::size_t quota = SIZE_MAX, QuotaMode mode = QuotaMode::Hard);
+
+    TenantMemoryResource(const TenantMemoryResource &) = delete;
+    TenantMemoryResource &operator=(const TenantMemoryResource &) = delete;
+
+    void *try_allocate_near(const void *hint, std::size_t bytes,
+                            std::size_t alignment = alignof(std::max_align_t)) override;
+
+    const std::string &name() const { return name_; }
+    std::pmr::memory_resource *parent() const { return parent_; }
+
+    std::size_t bytes_in_use() const { return bytes_in_use_; }
+    std::size_t blocks_in_use() const { return blocks_in_use_; }
+    std::size_t peak_bytes() const { return peak_bytes_; }
+    std::size_t quota() const { return quota_; }
+    QuotaMode quota_mode() const { return mode_; }
+    std::size_t quota_violations() const { return quota_violations_; }
+    std::size_t rejected_allocations() const { return rejected_allocations_; }
+
+    void set_quota(std::size_t quota, QuotaMode mode) { quota_ = quota; mode_ = mode; }
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+private:
+    // Проверка квоты; false - аллокацию нужно отклонить
+    bool admit(std::size_t bytes);
+    void account(std::size_t bytes);
+
+    std::pmr::memory_resource *parent_;
+    HintedMemoryResource *hinted_parent_;
+    std::string name_;
+    std::size_t quota_;
+    QuotaMode mode_;
+
+    std::size_t bytes_in_use_ = 0;
+    std::size_t blocks_in_use_ = 0;
+    std::size_t peak_bytes_ = 0;
+    std::size_t quota_violations_ = 0;
+    std::size_t rejected_allocations_ = 0;
+};
+
+#endif // TENANT_MEMORY_RESOURCE_H
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "MemoryResource.h"
 #include "List.h"
+#include "TenantMemoryResource.h"
 #include <iostream>
 #include <string>
 
@@ -212,6 +213,37 @@ void demonstrate_container_with_different_allocators() {
     mr2.dump();
 }
 
+void demonstrate_tenant_accounting() {
+    std::cout << "\n=== Demonstrating per-list accounting in one arena ===" << std::endl;
+    
+    MemoryResource mr(1024);
+    
+    // Каждый список получает свое представление арены; второму задана жесткая квота
+    TenantMemoryResource tenant1(&mr, "list1");
+    TenantMemoryResource tenant2(&mr, "list2", 128, QuotaMode::Hard);
+    
+    DoublyLinkedList<int> list1(&tenant1);
+    DoublyLinkedList<int> list2(&tenant2);
+    
+    for (int i = 0; i < 3; ++i) {
+        list1.push_back(i);
+    }
+    
+    int rejected = 0;
+    for (int i = 0; i < 10; ++i) {
+        if (!list2.try_push_back(i)) {
+            ++rejected;
+        }
+    }
+    
+    for (const TenantMemoryResource* t : {&tenant1, &tenant2}) {
+        std::cout << t->name() << ": " << t->blocks_in_use() << " blocks, "
+                  << t->bytes_in_use() << " bytes, rejected "
+                  << t->rejected_allocations() << std::endl;
+    }
+    std::cout << "list2 refused " << rejected << " insertions over its quota" << std::endl;
+}
+
 int main() {
     try {
         std::cout << "=== MemoryResource and DoublyLinkedList Demo ===" << std::endl;
@@ -221,6 +253,7 @@ int main() {
         demonstrate_iterator_operations();
         demonstrate_memory_reuse();
         demonstrate_container_with_different_allocators();
+        demonstrate_tenant_accounting();
         
         std::cout << "\n=== All demonstrations completed successfully ===" << std::endl;
     }
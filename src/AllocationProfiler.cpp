@@ -0,0 +1,181 @@
+#include "AllocationProfiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#define PMR_HAVE_BACKTRACE 1
+#endif
+
+namespace {
+
+thread_local const char *current_tag = nullptr;
+
+const int kMaxFrames = 16;
+// Запас под кадры профилировщика и ресурса, которые отрезаются по caller
+const int kMaxInternalFrames = 16;
+const int kSkipFrames = 2; // find_or_add_site, record - если caller неизвестен
+
+} // namespace
+
+ProfileScope::ProfileScope(const char *tag) : previous_(current_tag)
+{
+    current_tag = tag;
+}
+
+ProfileScope::~ProfileScope()
+{
+    current_tag = previous_;
+}
+
+const char *ProfileScope::current()
+{
+    return current_tag;
+}
+
+AllocationProfiler::AllocationProfiler(std::size_t sample_interval, unsigned seed)
+    : sample_interval_(sample_interval ? sample_interval : 1), bytes_until_sample_(0), rng_(seed)
+{
+    bytes_until_sample_ = next_interval();
+}
+
+std::size_t AllocationProfiler::next_interval()
+{
+    std::exponential_distribution<double> gap(1.0 / sample_interval_);
+    return static_cast<std::size_t>(gap(rng_)) + 1;
+}
+
+void AllocationProfiler::record(const void *p, std::size_t bytes, const void *caller)
+{
+    // Выбранный блок размера s представляет s / (1 - exp(-s / R)) байт
+    double s = static_cast<double>(bytes ? bytes : 1);
+    double weight = s / (1.0 - std::exp(-s / sample_interval_));
+
+    std::size_t site = find_or_add_site(caller);
+    Site &stats = sites_[site];
+    stats.live_samples++;
+    stats.live_bytes += weight;
+    stats.total_samples++;
+
+    live_[p] = {site, weight};
+}
+
+void AllocationProfiler::release(const void *p)
+{
+    auto it = live_.find(p);
+    if (it == live_.end())
+        return;
+
+    Site &stats = sites_[it->second.site];
+    stats.live_samples--;
+    stats.live_bytes -= it->second.weight;
+    live_.erase(it);
+}
+
+std::size_t AllocationProfiler::find_or_add_site(const void *caller)
+{
+    std::string key;
+    std::vector<void *> frames;
+
+    if (const char *tag = ProfileScope::current())
+    {
+        key = tag;
+    }
+    else
+    {
+#ifdef PMR_HAVE_BACKTRACE
+        void *buffer[kMaxFrames + kMaxInternalFrames];
+        int depth = backtrace(buffer, kMaxFrames + kMaxInternalFrames);
+
+        // Стек начинается с кадра, в который вернется вход в ресурс: иначе
+        // один и тот же вызов давал бы разные ключи в зависимости от пути
+        // внутри арены (carve_front/carve_back, try_allocate_near и т.д.)
+        int first = std::min(kSkipFrames, depth);
+        if (caller)
+        {
+            auto found = std::find(buffer, buffer + depth, caller);
+            if (found != buffer + depth)
+                first = static_cast<int>(found - buffer);
+        }
+
+        int last = std::min(depth, first + kMaxFrames);
+        for (int i = first; i < last; ++i)
+        {
+            frames.push_back(buffer[i]);
+            char address[2 + sizeof(void *) * 2 + 2];
+            std::snprintf(address, sizeof(address), "%p ", buffer[i]);
+            key += address;
+        }
+#endif
+        if (key.empty())
+            key = "<unknown>";
+    }
+
+    auto found = site_index_.find(key);
+    if (found != site_index_.end())
+        return found->second;
+
+    Site site;
+    site.name = key;
+    site.frames = std::move(frames);
+    sites_.push_back(std::move(site));
+    site_index_.emplace(key, sites_.size() - 1);
+    return sites_.size() - 1;
+}
+
+std::vector<AllocationProfiler::SiteStats> AllocationProfiler::snapshot() const
+{
+    std::vector<SiteStats> result;
+    for (const Site &site : sites_)
+    {
+        if (site.live_samples)
+            result.push_back({site.name, site.live_samples, site.live_bytes, site.total_samples});
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const SiteStats &a, const SiteStats &b) { return a.live_bytes > b.live_bytes; });
+    return result;
+}
+
+void AllocationProfiler::dump(std::ostream &os) const
+{
+    double total = 0.0;
+    for (const Site &site : sites_)
+        total += site.live_bytes;
+
+    os << "=== Heap profile (1 sample per ~" << sample_interval_ << " bytes) ===" << std::endl;
+    os << "Sampled live blocks: " << live_.size()
+       << ", estimated in-use bytes: " << static_cast<std::size_t>(total) << std::endl;
+
+    std::vector<const Site *> order;
+    for (const Site &site : sites_)
+    {
+        if (site.live_samples)
+            order.push_back(&site);
+    }
+    std::sort(order.begin(), order.end(),
+              [](const Site *a, const Site *b) { return a->live_bytes > b->live_bytes; });
+
+    for (const Site *site : order)
+    {
+        os << "  " << static_cast<std::size_t>(site->live_bytes) << " bytes, "
+           << site->live_samples << " samples: ";
+
+        if (site->frames.empty())
+        {
+            os << site->name << std::endl;
+            continue;
+        }
+
+        os << std::endl;
+#ifdef PMR_HAVE_BACKTRACE
+        char **symbols = backtrace_symbols(site->frames.data(), static_cast<int>(site->frames.size()));
+        for (std::size_t i = 0; i < site->frames.size(); ++i)
+            os << "      " << (symbols ? symbols[i] : "?") << std::endl;
+        std::free(symbols);
+#endif
+    }
+    os << "=========================" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "AllocationTrace.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const char kMagic[8] = {'P', 'M', 'R', 'T', 'R', 'A', 'C', 'E'};
+const std::uint32_t kVersion = 1;
+
+std::uint8_t log2_of(std::size_t alignment)
+{
+    std::uint8_t result = 0;
+    while (alignment >>= 1)
+        ++result;
+    return result;
+}
+
+// Трассы из TracingMemoryResource всегда проходят эти проверки; нарушение
+// означает испорченный файл, и воспроизводить его нельзя
+void validate_records(const std::vector<TraceRecord> &records, const std::string &path)
+{
+    std::vector<std::uint8_t> state(records.size(), 0); // 0 - не было, 1 - жив, 2 - освобожден
+
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        const TraceRecord &r = records[i];
+        auto corrupt = [&](const char *what) {
+            return std::runtime_error(std::string(what) + " in trace record " + std::to_string(i) + " of " + path);
+        };
+
+        if (r.id >= records.size())
+            throw corrupt("Invalid allocation id");
+        if (r.alignment_log2 > kMaxTraceAlignmentLog2)
+            throw corrupt("Invalid alignment");
+
+        std::uint8_t &s = state[static_cast<std::size_t>(r.id)];
+        if (r.op == TraceOp::Allocate)
+        {
+            if (s != 0)
+                throw corrupt("Duplicate allocation id");
+            s = 1;
+        }
+        else if (r.op == TraceOp::Deallocate)
+        {
+            if (s != 1)
+                throw corrupt("Deallocation without allocation");
+            s = 2;
+        }
+        else
+        {
+            throw corrupt("Unknown operation");
+        }
+    }
+}
+
+} // namespace
+
+void save_trace(const std::string &path, const std::vector<TraceRecord> &records)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+        throw std::runtime_error("Cannot open trace file for writing: " + path);
+    if (records.size() > std::numeric_limits<std::uint32_t>::max())
+        throw std::runtime_error("Too many records for trace format: " + path);
+
+    std::uint32_t count = static_cast<std::uint32_t>(records.size());
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char *>(&kVersion), sizeof(kVersion));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char *>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+
+    if (!out)
+        throw std::runtime_error("Failed to write trace file: " + path);
+}
+
+std::vector<TraceRecord> load_trace(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("Cannot open trace file: " + path);
+
+    char magic[sizeof(kMagic)];
+    std::uint32_t version = 0;
+    std::uint32_t count = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&count), sizeof(count));
+
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error("Not an allocation trace: " + path);
+    if (version != kVersion)
+        throw std::runtime_error("Unsupported trace version in " + path);
+
+    // count из заголовка не должен обещать больше записей, чем есть в файле,
+    // иначе испорченный заголовок приводит к огромной аллокации
+    std::streamoff header_end = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streamoff file_end = in.tellg();
+    in.seekg(header_end);
+    std::uint64_t remaining = static_cast<std::uint64_t>(file_end - header_end);
+    if (static_cast<std::uint64_t>(count) * sizeof(TraceRecord) > remaining)
+        throw std::runtime_error("Truncated trace file: " + path);
+
+    std::vector<TraceRecord> records(count);
+    in.read(reinterpret_cast<char *>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+    if (!in)
+        throw std::runtime_error("Truncated trace file: " + path);
+
+    validate_records(records, path);
+    return records;
+}
+
+TracingMemoryResource::TracingMemoryResource(std::pmr::memory_resource *upstream,
+                                             std::size_t expected_records)
+    : upstream_(upstream), next_id_(0), start_(std::chrono::steady_clock::now())
+{
+    records_.reserve(expected_records);
+}
+
+void *TracingMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void *p = upstream_->allocate(bytes, alignment);
+
+    std::uint64_t id = next_id_++;
+    live_ids_[p] = id;
+    record(TraceOp::Allocate, id, bytes, alignment);
+    return p;
+}
+
+void TracingMemoryResource::do_deallocate(void *p, std::size_t bytes, std::size_t alignment)
+{
+    auto it = live_ids_.find(p);
+    if (it == live_ids_.end())
+    {
+        throw std::runtime_error("Attempt to deallocate untraced block");
+    }
+
+    record(TraceOp::Deallocate, it->second, bytes, alignment);
+    live_ids_.erase(it);
+
+    upstream_->deallocate(p, bytes, alignment);
+}
+
+bool TracingMemoryResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+void TracingMemoryResource::record(TraceOp op, std::uint64_t id, std::size_t bytes, std::size_t alignment)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+
+    TraceRecord r{};
+    r.timestamp_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    r.id = id;
+    if (bytes > std::numeric_limits<std::uint32_t>::max())
+    {
+        r.size = std::numeric_limits<std::uint32_t>::max();
+        r.flags |= kTraceSizeClamped;
+    }
+    else
+    {
+        r.size = static_cast<std::uint32_t>(bytes);
+    }
+    r.op = op;
+    r.alignment_log2 = log2_of(alignment);
+    records_.push_back(r);
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "InPlaceHeap.h"
+
+namespace {
+
+std::size_t round_up(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+void InPlaceHeap::format(std::size_t first, std::size_t end)
+{
+    first = round_up(first, alignment());
+    std::size_t size = end > first ? (end - first) / alignment() * alignment() : 0;
+
+    state_->allocated_blocks = 0;
+    state_->free_head = npos;
+
+    if (size >= min_block_size())
+    {
+        BlockHeader *b = block_at(first);
+        b->size = size;
+        b->next_free = npos;
+        state_->free_head = first;
+    }
+}
+
+void *InPlaceHeap::allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (alignment > InPlaceHeap::alignment())
+        return nullptr;
+
+    std::size_t need = round_up(sizeof(BlockHeader) + (bytes ? bytes : 1), InPlaceHeap::alignment());
+
+    // First-fit по списку свободных блоков
+    std::uint64_t prev = npos;
+    std::uint64_t curr = state_->free_head;
+    while (curr != npos)
+    {
+        BlockHeader *b = block_at(curr);
+        if (b->size >= need)
+        {
+            std::uint64_t next = b->next_free;
+
+            // Остаток, в который помещается хотя бы заголовок с данными, отделяем
+            if (b->size - need >= 2 * sizeof(BlockHeader))
+            {
+                std::uint64_t rest = curr + need;
+                BlockHeader *r = block_at(rest);
+                r->size = b->size - need;
+                r->next_free = next;
+                next = rest;
+                b->size = need;
+            }
+
+            if (prev != npos)
+                block_at(prev)->next_free = next;
+            else
+                state_->free_head = next;
+
+            b->next_free = npos;
+            state_->allocated_blocks++;
+            return reinterpret_cast<char *>(b) + sizeof(BlockHeader);
+        }
+        prev = curr;
+        curr = b->next_free;
+    }
+
+    return nullptr;
+}
+
+void InPlaceHeap::deallocate(void *p)
+{
+    std::uint64_t offset = static_cast<std::uint64_t>(static_cast<char *>(p) - base_) - sizeof(BlockHeader);
+    BlockHeader *b = block_at(offset);
+
+    // Вставка в упорядоченный по смещению список
+    std::uint64_t prev = npos;
+    std::uint64_t curr = state_->free_head;
+    while (curr != npos && curr < offset)
+    {
+        prev = curr;
+        curr = block_at(curr)->next_free;
+    }
+
+    b->next_free = curr;
+    if (prev != npos)
+        block_at(prev)->next_free = offset;
+    else
+        state_->free_head = offset;
+
+    // Слияние со следующим и предыдущим соседями
+    if (curr != npos && offset + b->size == curr)
+    {
+        b->size += block_at(curr)->size;
+        b->next_free = block_at(curr)->next_free;
+    }
+    if (prev != npos && prev + block_at(prev)->size == offset)
+    {
+        block_at(prev)->size += b->size;
+        block_at(prev)->next_free = b->next_free;
+    }
+
+    state_->allocated_blocks--;
+}
\ No newline at end of file
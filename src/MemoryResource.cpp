@@ -1,17 +1,36 @@
 #include "MemoryResource.h"
 #include <algorithm>
 #include <cstring>
+#include <iterator>
 
-MemoryResource::MemoryResource(std::size_t total_size)
+// Отмечает публичный вход в арену: вложенные входы (do_allocate -> try_allocate)
+// не перезаписывают адрес внешнего вызывающего
+#if defined(PMR_ENABLE_PROFILER) && defined(__GNUC__)
+#define PMR_ALLOCATION_ENTRY() CallerScope caller_scope(caller_, __builtin_return_address(0))
+#else
+#define PMR_ALLOCATION_ENTRY()
+#endif
+
+namespace {
+
+// Окно поиска рядом с подсказкой: дальше выбор блока остается за стратегией
+const std::size_t kNearWindow = 1024; // байт от hint
+const std::size_t kNearProbes = 8;    // просмотренных свободных блоков
+
+} // namespace
+
+template <typename FitPolicy>
+BasicMemoryResource<FitPolicy>::BasicMemoryResource(std::size_t total_size)
     : buffer_(::operator new(total_size)), buffer_size_(total_size)
 {
-    free_blocks_[buffer_] = {total_size, true};
+    insert_free(buffer_, total_size);
 
     std::cout << "MemoryResource created with " << total_size
-              << " bytes at " << buffer_ << std::endl;
+              << " bytes at " << buffer_ << " (" << FitPolicy::name << ")" << std::endl;
 }
 
-MemoryResource::~MemoryResource()
+template <typename FitPolicy>
+BasicMemoryResource<FitPolicy>::~BasicMemoryResource()
 {
     if (!allocated_blocks_.empty())
     {
@@ -22,57 +41,158 @@ MemoryResource::~MemoryResource()
     ::operator delete(buffer_);
 }
 
-void *MemoryResource::do_allocate(std::size_t bytes, std::size_t alignment)
+template <typename FitPolicy>
+void *BasicMemoryResource<FitPolicy>::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    PMR_ALLOCATION_ENTRY();
+    void *p = try_allocate(bytes, alignment);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+template <typename FitPolicy>
+void *BasicMemoryResource<FitPolicy>::try_allocate(std::size_t bytes, std::size_t alignment)
 {
+    PMR_ALLOCATION_ENTRY();
+
     if (bytes == 0)
         bytes = 1;
 
     // Добавляем дополнительное пространство для выравнивания
     std::size_t required_size = aligned_size(bytes, alignment);
 
-    for (auto it = free_blocks_.begin(); it != free_blocks_.end(); ++it)
+    auto it = policy_.find(free_blocks_, required_size);
+    if (it == free_blocks_.end())
+        return nullptr;
+
+    return carve_front(it, bytes, alignment);
+}
+
+template <typename FitPolicy>
+void *BasicMemoryResource<FitPolicy>::try_allocate_near(const void *hint, std::size_t bytes, std::size_t alignment)
+{
+    PMR_ALLOCATION_ENTRY();
+
+    if (!hint)
+        return try_allocate(bytes, alignment);
+
+    if (bytes == 0)
+        bytes = 1;
+
+    std::size_t required_size = aligned_size(bytes, alignment);
+    const char *target = static_cast<const char *>(hint);
+
+    // Расходимся от hint в обе стороны, каждый раз проверяя ближайший блок
+    auto forward = free_blocks_.lower_bound(const_cast<void *>(hint));
+    auto backward = std::make_reverse_iterator(forward);
+
+    for (std::size_t probes = 0; probes < kNearProbes; ++probes)
     {
-        if (it->second.is_free && it->second.size >= required_size)
+        std::size_t forward_distance = SIZE_MAX;
+        if (forward != free_blocks_.end())
+            forward_distance = static_cast<const char *>(forward->first) - target;
+
+        std::size_t backward_distance = SIZE_MAX;
+        if (backward != free_blocks_.rend())
+        {
+            const char *block_end = static_cast<const char *>(backward->first) + backward->second.size;
+            backward_distance = block_end >= target ? 0 : target - block_end;
+        }
+
+        if (std::min(forward_distance, backward_distance) > kNearWindow)
+            break;
+
+        if (forward_distance <= backward_distance)
         {
-            void *block_addr = it->first;
-            std::size_t block_size = it->second.size;
-
-            // Выравниваем адрес
-            void *aligned_addr = align_pointer(block_addr, alignment);
-            std::size_t alignment_padding = 
-                static_cast<char*>(aligned_addr) - static_cast<char*>(block_addr);
-            
-            // Если перед выровненным адресом есть свободное пространство
-            if (alignment_padding > 0)
-            {
-                free_blocks_[block_addr] = {alignment_padding, true};
-                block_addr = aligned_addr;
-                block_size -= alignment_padding;
-            }
-
-            free_blocks_.erase(block_addr);
-
-            // Если после аллокации осталось свободное пространство
-            if (block_size > required_size)
-            {
-                void *free_part = static_cast<char *>(block_addr) + required_size;
-                std::size_t free_size = block_size - required_size;
-                free_blocks_[free_part] = {free_size, true};
-            }
-
-            allocated_blocks_[block_addr] = {required_size, false};
-
-            std::cout << "Allocated " << bytes << " bytes at " << block_addr 
-                      << " (actual size: " << required_size << " bytes, alignment: " 
-                      << alignment << ")" << std::endl;
-            return block_addr;
+            if (forward->second.size >= required_size)
+                return carve_front(forward, bytes, alignment);
+            ++forward;
+        }
+        else
+        {
+            if (backward->second.size >= required_size)
+                return carve_back(std::prev(backward.base()), bytes, alignment);
+            ++backward;
         }
     }
 
-    throw std::bad_alloc();
+    // Рядом с hint места нет: обычный выбор по стратегии
+    return try_allocate(bytes, alignment);
+}
+
+template <typename FitPolicy>
+void *BasicMemoryResource<FitPolicy>::carve_front(typename BlockMap::iterator it, std::size_t bytes, std::size_t alignment)
+{
+    std::size_t required_size = aligned_size(bytes, alignment);
+
+    void *block_addr = it->first;
+    std::size_t block_size = it->second.size;
+    erase_free(it);
+
+    // Выравниваем адрес
+    void *aligned_addr = align_pointer(block_addr, alignment);
+    std::size_t alignment_padding =
+        static_cast<char*>(aligned_addr) - static_cast<char*>(block_addr);
+
+    // Если перед выровненным адресом есть свободное пространство
+    if (alignment_padding > 0)
+    {
+        insert_free(block_addr, alignment_padding);
+        block_addr = aligned_addr;
+        block_size -= alignment_padding;
+    }
+
+    // После отступа в блоке может остаться меньше required_size (но не меньше bytes)
+    std::size_t used_size = std::min(block_size, required_size);
+
+    // Если после аллокации осталось свободное пространство
+    if (block_size > used_size)
+    {
+        void *free_part = static_cast<char *>(block_addr) + used_size;
+        insert_free(free_part, block_size - used_size);
+    }
+
+    record_allocation(block_addr, used_size, bytes);
+
+    if (verbose_)
+    {
+        std::cout << "Allocated " << bytes << " bytes at " << block_addr
+                  << " (actual size: " << used_size << " bytes, alignment: "
+                  << alignment << ")" << std::endl;
+    }
+    return block_addr;
+}
+
+template <typename FitPolicy>
+void *BasicMemoryResource<FitPolicy>::carve_back(typename BlockMap::iterator it, std::size_t bytes, std::size_t alignment)
+{
+    char *block_begin = static_cast<char *>(it->first);
+    char *block_end = block_begin + it->second.size;
+    erase_free(it);
+
+    // Самый старший выровненный адрес, с которого помещается bytes
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block_end - bytes);
+    start -= start % alignment;
+    char *block_addr = reinterpret_cast<char *>(start);
+
+    if (block_addr > block_begin)
+        insert_free(block_begin, block_addr - block_begin);
+
+    std::size_t used_size = block_end - block_addr;
+    record_allocation(block_addr, used_size, bytes);
+
+    if (verbose_)
+    {
+        std::cout << "Allocated " << bytes << " bytes at " << static_cast<void *>(block_addr)
+                  << " (actual size: " << used_size << " bytes, alignment: "
+                  << alignment << ", from block end)" << std::endl;
+    }
+    return block_addr;
 }
 
-void MemoryResource::do_deallocate(void *p, std::size_t bytes [[maybe_unused]], std::size_t alignment [[maybe_unused]])
+template <typename FitPolicy>
+void BasicMemoryResource<FitPolicy>::do_deallocate(void *p, std::size_t bytes [[maybe_unused]], std::size_t alignment [[maybe_unused]])
 {
     auto it = allocated_blocks_.find(p);
     if (it == allocated_blocks_.end())
@@ -81,21 +201,136 @@ void MemoryResource::do_deallocate(void *p, std::size_t bytes [[maybe_unused]],
     }
 
     std::size_t actual_size = it->second.size;
+#ifdef PMR_ENABLE_PROFILER
+    if (it->second.sampled && profiler_)
+        profiler_->release(p);
+#endif
     allocated_blocks_.erase(it);
 
-    free_blocks_[p] = {actual_size, true};
+    insert_free(p, actual_size);
 
     merge_adjacent_free_blocks();
 
-    std::cout << "Deallocated block at " << p << " (" << actual_size << " bytes)" << std::endl;
+    if (verbose_)
+        std::cout << "Deallocated block at " << p << " (" << actual_size << " bytes)" << std::endl;
 }
 
-bool MemoryResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+template <typename FitPolicy>
+bool BasicMemoryResource<FitPolicy>::do_is_equal(const std::pmr::memory_resource &other) const noexcept
 {
     return this == &other;
 }
 
-void MemoryResource::merge_adjacent_free_blocks()
+template <typename FitPolicy>
+bool BasicMemoryResource<FitPolicy>::try_expand(void *p, std::size_t old_size [[maybe_unused]], std::size_t new_size)
+{
+    auto it = allocated_blocks_.find(p);
+    if (it == allocated_blocks_.end())
+    {
+        throw std::runtime_error("Attempt to expand unknown block");
+    }
+
+    std::size_t current_size = it->second.size;
+    if (new_size <= current_size)
+        return true;
+
+    // Расширяться можно только в свободный блок, начинающийся сразу за нашим
+    auto next = free_blocks_.find(static_cast<char *>(p) + current_size);
+    if (next == free_blocks_.end() || current_size + next->second.size < new_size)
+        return false;
+
+    std::size_t available = next->second.size;
+    erase_free(next);
+
+    std::size_t growth = new_size - current_size;
+    if (available > growth)
+        insert_free(static_cast<char *>(p) + new_size, available - growth);
+
+    it->second.size = new_size;
+
+    if (verbose_)
+        std::cout << "Expanded block at " << p << " from " << current_size
+                  << " to " << new_size << " bytes" << std::endl;
+    return true;
+}
+
+template <typename FitPolicy>
+bool BasicMemoryResource<FitPolicy>::shrink_in_place(void *p, std::size_t old_size [[maybe_unused]], std::size_t new_size)
+{
+    auto it = allocated_blocks_.find(p);
+    if (it == allocated_blocks_.end())
+    {
+        throw std::runtime_error("Attempt to shrink unknown block");
+    }
+
+    if (new_size == 0)
+        new_size = 1;
+
+    std::size_t current_size = it->second.size;
+    if (new_size >= current_size)
+        return false;
+
+    it->second.size = new_size;
+    insert_free(static_cast<char *>(p) + new_size, current_size - new_size);
+
+    merge_adjacent_free_blocks();
+
+    if (verbose_)
+        std::cout << "Shrunk block at " << p << " from " << current_size
+                  << " to " << new_size << " bytes" << std::endl;
+    return true;
+}
+
+template <typename FitPolicy>
+std::size_t BasicMemoryResource<FitPolicy>::free_bytes() const
+{
+    std::size_t total = 0;
+    for (const auto &[addr, info] : free_blocks_)
+        total += info.size;
+    return total;
+}
+
+template <typename FitPolicy>
+std::size_t BasicMemoryResource<FitPolicy>::largest_free_block() const
+{
+    std::size_t largest = 0;
+    for (const auto &[addr, info] : free_blocks_)
+        largest = std::max(largest, info.size);
+    return largest;
+}
+
+template <typename FitPolicy>
+void BasicMemoryResource<FitPolicy>::record_allocation(void *p, std::size_t used_size, std::size_t bytes [[maybe_unused]])
+{
+    BlockInfo &info = allocated_blocks_[p];
+    info = {used_size, false};
+
+#ifdef PMR_ENABLE_PROFILER
+    if (profiler_ && profiler_->should_sample(bytes))
+    {
+        info.sampled = true;
+        profiler_->record(p, bytes, caller_);
+    }
+#endif
+}
+
+template <typename FitPolicy>
+void BasicMemoryResource<FitPolicy>::insert_free(void *p, std::size_t size)
+{
+    free_blocks_[p] = {size, true};
+    policy_.on_insert(p, size);
+}
+
+template <typename FitPolicy>
+typename BasicMemoryResource<FitPolicy>::BlockMap::iterator
+BasicMemoryResource<FitPolicy>::erase_free(typename BlockMap::iterator it)
+{
+    policy_.on_erase(it->first, it->second.size);
+    return free_blocks_.erase(it);
+}
+
+template <typename FitPolicy>
+void BasicMemoryResource<FitPolicy>::merge_adjacent_free_blocks()
 {
     if (free_blocks_.empty()) return;
 
@@ -105,14 +340,16 @@ void MemoryResource::merge_adjacent_free_blocks()
     while (next != free_blocks_.end())
     {
         void *current_end = static_cast<char *>(current->first) + current->second.size;
-        
+
         if (current_end == next->first)
         {
             // Объединяем текущий блок со следующим
+            policy_.on_erase(current->first, current->second.size);
             current->second.size += next->second.size;
-            
+            policy_.on_insert(current->first, current->second.size);
+
             // Удаляем следующий блок
-            free_blocks_.erase(next++);
+            next = erase_free(next);
         }
         else
         {
@@ -120,4 +357,9 @@ void MemoryResource::merge_adjacent_free_blocks()
             ++next;
         }
     }
-}
\ No newline at end of file
+}
+
+template class BasicMemoryResource<FirstFit>;
+template class BasicMemoryResource<NextFit>;
+template class BasicMemoryResource<BestFit>;
+template class BasicMemoryResource<SegregatedFit>;
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "SharedMemoryResource.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const std::uint64_t kMagic = 0x504d52534841524dULL; // "PMRSHARM"
+const std::size_t kHeaderSize = 128; // место под SegmentHeader в начале сегмента
+
+std::runtime_error system_error(const std::string &what, const std::string &name)
+{
+    return std::runtime_error(what + " '" + name + "': " + std::strerror(errno));
+}
+
+} // namespace
+
+struct SharedMemoryResource::SegmentHeader
+{
+    std::uint64_t magic;
+    std::uint64_t size;
+    pthread_mutex_t mutex;
+    std::uint64_t root;             // смещение корневого объекта
+    InPlaceHeap::State heap;
+};
+
+class SharedMemoryResource::Lock
+{
+public:
+    explicit Lock(SegmentHeader *h) : mutex_(&h->mutex)
+    {
+        int rc = pthread_mutex_lock(mutex_);
+        // Владелец умер, удерживая мьютекс: помечаем мьютекс рабочим,
+        // чтобы остальные процессы не зависли навсегда
+        if (rc == EOWNERDEAD)
+            pthread_mutex_consistent(mutex_);
+        else if (rc != 0)
+            throw std::runtime_error("Cannot lock shared memory mutex");
+    }
+
+    ~Lock() { pthread_mutex_unlock(mutex_); }
+
+    Lock(const Lock &) = delete;
+    Lock &operator=(const Lock &) = delete;
+
+private:
+    pthread_mutex_t *mutex_;
+};
+
+SharedMemoryResource::SharedMemoryResource(const std::string &name, std::size_t total_size)
+    : name_(name), base_(nullptr), mapped_size_(0), owner_(true)
+{
+    static_assert(sizeof(SegmentHeader) <= kHeaderSize, "SegmentHeader must fit into the reserved prefix");
+
+    // Иначе заголовок сегмента записался бы за пределы отображения
+    if (total_size < kHeaderSize + InPlaceHeap::min_block_size())
+        throw std::invalid_argument("Shared memory segment '" + name + "' is too small");
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        throw system_error("Cannot create shared memory segment", name);
+
+    if (ftruncate(fd, static_cast<off_t>(total_size)) != 0)
+    {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw system_error("Cannot resize shared memory segment", name);
+    }
+
+    try
+    {
+        map(fd, total_size);
+    }
+    catch (...)
+    {
+        shm_unlink(name.c_str());
+        throw;
+    }
+
+    SegmentHeader *h = header();
+    h->size = total_size;
+    h->root = 0;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&h->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    // Вся память после заголовка сегмента - один свободный блок
+    heap().format(kHeaderSize, total_size);
+
+    // magic пишется последним: по нему подключающиеся процессы видят готовый сегмент
+    h->magic = kMagic;
+}
+
+SharedMemoryResource::SharedMemoryResource(const std::string &name)
+    : name_(name), base_(nullptr), mapped_size_(0), owner_(false)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+        throw system_error("Cannot open shared memory segment", name);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw system_error("Cannot stat shared memory segment", name);
+    }
+
+    map(fd, static_cast<std::size_t>(st.st_size));
+
+    if (header()->magic != kMagic)
+    {
+        munmap(base_, mapped_size_);
+        throw std::runtime_error("Shared memory segment '" + name + "' is not initialized");
+    }
+}
+
+SharedMemoryResource::~SharedMemoryResource()
+{
+    munmap(base_, mapped_size_);
+    if (owner_)
+        shm_unlink(name_.c_str());
+}
+
+void SharedMemoryResource::map(int fd, std::size_t size)
+{
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        throw system_error("Cannot map shared memory segment", name_);
+
+    base_ = p;
+    mapped_size_ = size;
+}
+
+InPlaceHeap SharedMemoryResource::heap() const
+{
+    return InPlaceHeap(base_, &header()->heap);
+}
+
+std::uint64_t SharedMemoryResource::to_offset(const void *p) const
+{
+    if (!p)
+        return 0;
+    return static_cast<std::uint64_t>(static_cast<const char *>(p) - static_cast<const char *>(base_));
+}
+
+void *SharedMemoryResource::from_offset(std::uint64_t offset) const
+{
+    if (!offset)
+        return nullptr;
+    return static_cast<char *>(base_) + offset;
+}
+
+void SharedMemoryResource::set_root(const void *p)
+{
+    Lock lock(header());
+    header()->root = to_offset(p);
+}
+
+void *SharedMemoryResource::root() const
+{
+    Lock lock(header());
+    return from_offset(header()->root);
+}
+
+std::size_t SharedMemoryResource::allocated_block_count() const
+{
+    Lock lock(header());
+    return heap().allocated_blocks();
+}
+
+void *SharedMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void *p = nullptr;
+    {
+        Lock lock(header());
+        p = heap().allocate(bytes, alignment);
+    }
+
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void SharedMemoryResource::do_deallocate(void *p, std::size_t bytes [[maybe_unused]], std::size_t alignment [[maybe_unused]])
+{
+    std::uint64_t offset = to_offset(p);
+    if (offset < kHeaderSize || offset >= mapped_size_)
+    {
+        throw std::runtime_error("Attempt to deallocate block outside shared segment");
+    }
+
+    Lock lock(header());
+    heap().deallocate(p);
+}
+
+bool SharedMemoryResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "TenantMemoryResource.h"
+#include <new>
+#include <utility>
+
+TenantMemoryResource::TenantMemoryResource(std::pmr::memory_resource *parent, std::string name,
+                                           std::size_t quota, QuotaMode mode)
+    : parent_(parent), hinted_parent_(dynamic_cast<HintedMemoryResource *>(parent)),
+      name_(std::move(name)), quota_(quota), mode_(mode)
+{
+}
+
+void *TenantMemoryResource::try_allocate_near(const void *hint, std::size_t bytes, std::size_t alignment)
+{
+    if (!admit(bytes))
+        return nullptr;
+
+    void *p = nullptr;
+    if (hinted_parent_)
+    {
+        p = hinted_parent_->try_allocate_near(hint, bytes, alignment);
+    }
+    else
+    {
+        try
+        {
+            p = parent_->allocate(bytes, alignment);
+        }
+        catch (const std::bad_alloc &)
+        {
+            return nullptr;
+        }
+    }
+
+    if (p)
+        account(bytes);
+    return p;
+}
+
+void *TenantMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (!admit(bytes))
+        throw std::bad_alloc();
+
+    void *p = parent_->allocate(bytes, alignment);
+    account(bytes);
+    return p;
+}
+
+void TenantMemoryResource::do_deallocate(void *p, std::size_t bytes, std::size_t alignment)
+{
+    parent_->deallocate(p, bytes, alignment);
+    bytes_in_use_ -= bytes;
+    blocks_in_use_--;
+}
+
+bool TenantMemoryResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+bool TenantMemoryResource::admit(std::size_t bytes)
+{
+    if (bytes <= quota_ && bytes_in_use_ <= quota_ - bytes)
+        return true;
+
+    if (mode_ == QuotaMode::Hard)
+    {
+        rejected_allocations_++;
+        return false;
+    }
+
+    quota_violations_++;
+    return true;
+}
+
+void TenantMemoryResource::account(std::size_t bytes)
+{
+    bytes_in_use_ += bytes;
+    blocks_in_use_++;
+    if (bytes_in_use_ > peak_bytes_)
+        peak_bytes_ = bytes_in_use_;
+}
\ No newline at end of file
@@ -1,8 +1,24 @@
 #include "MemoryResource.h"
 #include "List.h"
+#include "ArenaVector.h"
+#include "AllocationTrace.h"
+#include "LruCache.h"
+#include "TenantMemoryResource.h"
+#include "InlineMemoryResource.h"
+#include "IntrusiveList.h"
+#include "AllocationProfiler.h"
+#include <fstream>
+#include <sstream>
+#ifdef PMR_HAVE_SHARED_MEMORY
+#include "SharedList.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 #include <gtest/gtest.h>
 #include <type_traits>
 #include <iostream>
+#include <vector>
+#include <cstdio>
 
 TEST(MemoryResource, BasicAllocation) {
     MemoryResource mr(256);
@@ -45,6 +61,943 @@ TEST(MemoryResource, MemoryReuse) {
     mr.deallocate(p2, 32, 8);
 }
 
+template <typename Resource>
+class FitPolicyTest : public ::testing::Test {};
+
+using FitResources = ::testing::Types<MemoryResource, NextFitMemoryResource,
+                                      BestFitMemoryResource, SegregatedMemoryResource>;
+TYPED_TEST_SUITE(FitPolicyTest, FitResources);
+
+TYPED_TEST(FitPolicyTest, AllocateReuseAndOutOfMemory) {
+    TypeParam mr(256);
+    mr.set_verbose(false);
+
+    void* p1 = mr.allocate(32, 8);
+    void* p2 = mr.allocate(64, 8);
+    ASSERT_NE(p1, nullptr);
+    ASSERT_NE(p2, nullptr);
+    EXPECT_THROW({
+        void* p3 = mr.allocate(512, 8);
+        (void)p3;
+    }, std::bad_alloc);
+
+    mr.deallocate(p1, 32, 8);
+    mr.deallocate(p2, 64, 8);
+
+    // После освобождения всё снова сливается в один блок
+    EXPECT_EQ(mr.free_block_count(), 1u);
+    EXPECT_EQ(mr.free_bytes(), mr.capacity());
+}
+
+TYPED_TEST(FitPolicyTest, WorksAsListResource) {
+    TypeParam mr(2048);
+    mr.set_verbose(false);
+    {
+        DoublyLinkedList<int> list(&mr);
+        for (int i = 0; i < 20; ++i)
+            list.push_back(i);
+        for (int i = 0; i < 10; ++i)
+            list.pop_front();
+        for (int i = 0; i < 10; ++i)
+            list.push_front(i);
+        EXPECT_EQ(list.size(), 20u);
+    }
+    EXPECT_EQ(mr.allocated_block_count(), 0u);
+}
+
+TEST(FitPolicies, BestFitChoosesSmallestHole) {
+    BestFitMemoryResource mr(1024);
+    mr.set_verbose(false);
+
+    // Дыры размером 200 и 40 байт, разделенные занятыми блоками
+    void* big = mr.allocate(193, 8);
+    void* sep1 = mr.allocate(8, 8);
+    void* small = mr.allocate(33, 8);
+    void* sep2 = mr.allocate(8, 8);
+    mr.deallocate(big, 193, 8);
+    mr.deallocate(small, 33, 8);
+
+    void* p = mr.allocate(24, 8);
+    EXPECT_EQ(p, small);
+
+    mr.deallocate(p, 24, 8);
+    mr.deallocate(sep1, 8, 8);
+    mr.deallocate(sep2, 8, 8);
+}
+
+TEST(FitPolicies, NextFitContinuesFromLastAllocation) {
+    NextFitMemoryResource mr(1024);
+    mr.set_verbose(false);
+
+    void* a = mr.allocate(57, 8);
+    void* b = mr.allocate(57, 8);
+    mr.deallocate(a, 57, 8);
+
+    // First-fit вернул бы дыру на месте a, next-fit продолжает после b
+    void* c = mr.allocate(57, 8);
+    EXPECT_GT(c, b);
+
+    mr.deallocate(b, 57, 8);
+    mr.deallocate(c, 57, 8);
+}
+
+TEST(MemoryResource, ExpandIntoAdjacentFreeBlock) {
+    MemoryResource mr(256);
+    mr.set_verbose(false);
+
+    void* p = mr.allocate(32, 8);
+    EXPECT_TRUE(mr.try_expand(p, 32, 128));
+    EXPECT_EQ(mr.free_bytes(), mr.capacity() - 128);
+
+    // Сосед занят - расширение невозможно
+    void* q = mr.allocate(16, 8);
+    EXPECT_FALSE(mr.try_expand(p, 128, 160));
+
+    mr.deallocate(q, 16, 8);
+    mr.deallocate(p, 128, 8);
+    EXPECT_EQ(mr.free_block_count(), 1u);
+}
+
+TEST(MemoryResource, ShrinkReturnsTail) {
+    MemoryResource mr(256);
+    mr.set_verbose(false);
+
+    void* p = mr.allocate(128, 8);
+    void* q = mr.allocate(16, 8);
+    std::size_t free_before = mr.free_bytes();
+    ASSERT_TRUE(mr.shrink_in_place(p, 128, 32));
+    EXPECT_GE(mr.free_bytes(), free_before + 96);
+
+    // Освободившийся хвост используется следующими аллокациями
+    void* r = mr.allocate(40, 8);
+    EXPECT_GT(r, p);
+    EXPECT_LT(r, q);
+
+    mr.deallocate(r, 40, 8);
+    mr.deallocate(q, 16, 8);
+    mr.deallocate(p, 32, 8);
+    EXPECT_EQ(mr.free_block_count(), 1u);
+}
+
+TEST(ArenaVector, GrowsInPlace) {
+    MemoryResource mr(4096);
+    mr.set_verbose(false);
+    {
+        ArenaVector<int> vec(&mr);
+        vec.push_back(0);
+        int* first = vec.data();
+        for (int i = 1; i < 100; ++i)
+            vec.push_back(i);
+
+        // Справа от буфера свободно, поэтому данные не переезжали
+        EXPECT_EQ(vec.data(), first);
+        for (int i = 0; i < 100; ++i)
+            EXPECT_EQ(vec[i], i);
+
+        vec.shrink_to_fit();
+        EXPECT_EQ(vec.capacity(), 100u);
+        EXPECT_EQ(vec.data(), first);
+    }
+    EXPECT_EQ(mr.allocated_block_count(), 0u);
+}
+
+TEST(ArenaVector, RelocatesWhenNeighborIsBusy) {
+    MemoryResource mr(4096);
+    mr.set_verbose(false);
+    {
+        ArenaVector<std::string> vec(&mr);
+        vec.push_back("first");
+        void* blocker = mr.allocate(8, 8);
+        for (int i = 0; i < 10; ++i)
+            vec.push_back(std::to_string(i));
+
+        EXPECT_EQ(vec[0], "first");
+        EXPECT_EQ(vec.back(), "9");
+        mr.deallocate(blocker, 8, 8);
+    }
+    EXPECT_EQ(mr.allocated_block_count(), 0u);
+}
+
+TEST(ArenaVector, PushBackOfOwnElementSurvivesRelocation) {
+    MemoryResource mr(4096);
+    mr.set_verbose(false);
+    {
+        const std::string text(40, 'x');
+        ArenaVector<std::string> vec(&mr);
+        for (int i = 0; i < 4; ++i)
+            vec.push_back(text);
+        void* blocker = mr.allocate(8, 8);
+
+        // Аргумент ссылается на vec[0], а вектору нужно переехать
+        std::string* before = vec.data();
+        vec.push_back(vec[0]);
+        EXPECT_NE(vec.data(), before);
+        EXPECT_EQ(vec.size(), 5u);
+        EXPECT_EQ(vec.back(), text);
+        EXPECT_EQ(vec[0], text);
+
+        mr.deallocate(blocker, 8, 8);
+    }
+    EXPECT_EQ(mr.allocated_block_count(), 0u);
+}
+
+namespace {
+// Копирование бросает после заданного числа копий; перемещение не noexcept,
+// поэтому при переезде ArenaVector копирует
+struct ThrowingCopy {
+    static int copies_left;
+    static int alive;
+    int value;
+
+    explicit ThrowingCopy(int v) : value(v) { ++alive; }
+    ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+        if (copies_left-- == 0)
+            throw std::runtime_error("copy failed");
+        ++alive;
+    }
+    ThrowingCopy(ThrowingCopy&& other) : value(other.value) { ++alive; }
+    ~ThrowingCopy() { --alive; }
+};
+int ThrowingCopy::copies_left = -1;
+int ThrowingCopy::alive = 0;
+}
+
+TEST(ArenaVector, RelocationIsExceptionSafe) {
+    MemoryResource mr(4096);
+    mr.set_verbose(false);
+    {
+        ArenaVector<ThrowingCopy> vec(&mr);
+        for (int i = 0; i < 4; ++i)
+            vec.emplace_back(i);
+        // Соседний блок занят, поэтому следующий рост требует переезда
+        void* blocker = mr.allocate(8, 8);
+
+        ThrowingCopy::copies_left = 2;
+        EXPECT_THROW(vec.emplace_back(4), std::runtime_error);
+        ThrowingCopy::copies_left = -1;
+
+        // Вектор остался прежним, лишний блок вернулся в арену
+        EXPECT_EQ(vec.size(), 4u);
+        EXPECT_EQ(vec.capacity(), 4u);
+        for (int i = 0; i < 4; ++i)
+            EXPECT_EQ(vec[i].value, i);
+        EXPECT_EQ(ThrowingCopy::alive, 4);
+        EXPECT_EQ(mr.allocated_block_count(), 2u);
+
+        mr.deallocate(blocker, 8, 8);
+    }
+    EXPECT_EQ(ThrowingCopy::alive, 0);
+    EXPECT_EQ(mr.allocated_block_count(), 0u);
+}
+
+TEST(MemoryResource, AllocateNearPicksClosestHole) {
+    MemoryResource mr(1024);
+    mr.set_verbose(false);
+
+    void* blocks[8];
+    for (auto& b : blocks)
+        b = mr.allocate(64, 8);
+
+    // Дыры в начале арены и рядом с blocks[6]
+    mr.deallocate(blocks[1], 64, 8);
+    mr.deallocate(blocks[5], 64, 8);
+
+    void* p = mr.allocate_near(blocks[6], 32, 8);
+    EXPECT_GT(p, blocks[4]);
+    EXPECT_LT(p, blocks[6]);
+
+    mr.deallocate(p, 32, 8);
+    for (int i : {0, 2, 3, 4, 6, 7})
+        mr.deallocate(blocks[i], 64, 8);
+    EXPECT_EQ(mr.free_block_count(), 1u);
+}
+
+namespace {
+// Раскладка: [M=256][sep][S=64][sep][L=512][sep][2 КиБ][хвост списка][занято].
+// Рядом с хвостом свободных блоков нет, поэтому новый узел выбирает стратегия.
+// Возвращает индекс дыры (0 - M, 1 - S, 2 - L), в которую попал узел.
+template <typename Resource>
+int hinted_node_hole() {
+    Resource mr(8192);
+    mr.set_verbose(false);
+
+    const std::size_t sizes[] = {256, 64, 512};
+    char* holes[3];
+    void* seps[3];
+    for (int i = 0; i < 3; ++i) {
+        holes[i] = static_cast<char*>(mr.allocate(sizes[i], 8));
+        seps[i] = mr.allocate(8, 8);
+    }
+    void* filler = mr.allocate(2048, 8);
+
+    int result = -1;
+    {
+        DoublyLinkedList<int> list(&mr);
+        list.push_back(1);
+        std::size_t rest = mr.largest_free_block();
+        void* tail_fill = mr.allocate(rest - 7, 8);
+
+        for (int i = 0; i < 3; ++i)
+            mr.deallocate(holes[i], sizes[i], 8);
+
+        list.push_back(2);  // подсказка - адрес хвоста
+        const char* node = reinterpret_cast<const char*>(&list.back());
+        for (int i = 0; i < 3; ++i) {
+            if (node >= holes[i] && node < holes[i] + sizes[i])
+                result = i;
+        }
+        list.pop_back();
+        mr.deallocate(tail_fill, rest - 7, 8);
+    }
+    mr.deallocate(filler, 2048, 8);
+    for (void* sep : seps)
+        mr.deallocate(sep, 8, 8);
+    return result;
+}
+}
+
+TEST(MemoryResource, AllocateNearFallsBackToPolicyOutsideWindow) {
+    // Ближайшая к хвосту дыра - L; стратегия все равно решает сама
+    EXPECT_EQ(hinted_node_hole<MemoryResource>(), 0);
+    EXPECT_EQ(hinted_node_hole<BestFitMemoryResource>(), 1);
+}
+
+TEST(DoublyLinkedList, InsertPlacesNodeNearNeighbor) {
+    MemoryResource mr(2048);
+    mr.set_verbose(false);
+    DoublyLinkedList<int> list(&mr);
+
+    for (int i = 0; i < 6; ++i)
+        list.push_back(i);
+
+    std::vector<const int*> addr;
+    for (const auto& v : list)
+        addr.push_back(&v);
+
+    // Освобождаем узлы 1 и 4; first-fit занял бы дыру узла 1
+    auto it = list.begin();
+    ++it;
+    it = list.erase(it);
+    ++it;
+    ++it;
+    it = list.erase(it);
+
+    it = list.insert(it, 42); // перед узлом 5
+    EXPECT_GT(&*it, addr[3]);
+    EXPECT_LT(&*it, addr[5]);
+}
+
+TEST(AllocationTrace, RecordsAndRoundTrips) {
+    MemoryResource mr(1024);
+    mr.set_verbose(false);
+    TracingMemoryResource tracer(&mr);
+    {
+        DoublyLinkedList<int> list(&tracer);
+        list.push_back(1);
+        list.push_back(2);
+        list.pop_front();
+    }
+
+    const auto& records = tracer.records();
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].op, TraceOp::Allocate);
+    EXPECT_EQ(records[1].op, TraceOp::Allocate);
+    EXPECT_EQ(records[2].op, TraceOp::Deallocate);
+    EXPECT_EQ(records[2].id, records[0].id);
+    EXPECT_EQ(records[3].id, records[1].id);
+    EXPECT_LE(records[0].timestamp_ns, records[3].timestamp_ns);
+
+    const std::string path = ::testing::TempDir() + "pmr_trace_roundtrip.bin";
+    tracer.save(path);
+    auto loaded = load_trace(path);
+    ASSERT_EQ(loaded.size(), records.size());
+    for (std::size_t i = 0; i < loaded.size(); ++i) {
+        EXPECT_EQ(loaded[i].id, records[i].id);
+        EXPECT_EQ(loaded[i].size, records[i].size);
+        EXPECT_EQ(loaded[i].op, records[i].op);
+        EXPECT_EQ(loaded[i].alignment_log2, records[i].alignment_log2);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(AllocationTrace, RejectsCountBeyondFileSize) {
+    const std::string path = ::testing::TempDir() + "pmr_trace_corrupt.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        const std::uint32_t version = 1;
+        const std::uint32_t count = 0xFFFFFFFFu;  // ~96 ГиБ записей
+        out.write("PMRTRACE", 8);
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write("0123456789", 10);
+    }
+    EXPECT_THROW(load_trace(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(AllocationTrace, RejectsCorruptRecords) {
+    const std::string path = ::testing::TempDir() + "pmr_trace_bad_records.bin";
+    auto make = [](TraceOp op, std::uint64_t id, std::uint8_t alignment_log2) {
+        TraceRecord r{};
+        r.id = id;
+        r.size = 16;
+        r.op = op;
+        r.alignment_log2 = alignment_log2;
+        return r;
+    };
+    const TraceRecord ok = make(TraceOp::Allocate, 0, 3);
+
+    const std::vector<std::vector<TraceRecord>> corrupt = {
+        {ok, make(TraceOp::Allocate, UINT64_MAX, 3)},       // id вне диапазона
+        {ok, make(TraceOp::Allocate, std::uint64_t(1) << 40, 3)},
+        {ok, make(TraceOp::Allocate, 1, 200)},              // сдвиг на 200 бит
+        {make(TraceOp::Deallocate, 0, 3)},                  // освобождение без выделения
+        {ok, make(TraceOp::Deallocate, 0, 3), make(TraceOp::Deallocate, 0, 3)},
+        {ok, ok},                                           // id выделен дважды
+    };
+    for (std::size_t i = 0; i < corrupt.size(); ++i) {
+        save_trace(path, corrupt[i]);
+        EXPECT_THROW(load_trace(path), std::runtime_error) << "case " << i;
+    }
+
+    save_trace(path, {ok, make(TraceOp::Deallocate, 0, 3)});
+    EXPECT_EQ(load_trace(path).size(), 2u);
+    std::remove(path.c_str());
+}
+
+namespace {
+// Отдает один и тот же буфер на любой запрос - позволяет "выделить" > 4 ГиБ
+class HugeRequestResource : public std::pmr::memory_resource {
+    alignas(std::max_align_t) char buffer_[64];
+    void* do_allocate(std::size_t, std::size_t) override { return buffer_; }
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+}
+
+TEST(AllocationTrace, MarksSizesAbove4GiB) {
+    HugeRequestResource upstream;
+    TracingMemoryResource tracer(&upstream);
+    const std::size_t huge = std::size_t(5) << 30;
+
+    void* p = tracer.allocate(huge, 8);
+    tracer.deallocate(p, huge, 8);
+    void* q = tracer.allocate(100, 8);
+    tracer.deallocate(q, 100, 8);
+
+    const auto& records = tracer.records();
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].size, 0xFFFFFFFFu);
+    EXPECT_TRUE(records[0].flags & kTraceSizeClamped);
+    EXPECT_TRUE(records[1].flags & kTraceSizeClamped);
+    EXPECT_EQ(records[2].size, 100u);
+    EXPECT_FALSE(records[2].flags & kTraceSizeClamped);
+}
+
+TEST(MemoryResource, TryAllocateReturnsNullWhenFull) {
+    MemoryResource mr(100);
+    mr.set_verbose(false);
+
+    void* p1 = mr.try_allocate(80, 8);
+    ASSERT_NE(p1, nullptr);
+    EXPECT_EQ(mr.try_allocate(50, 8), nullptr);
+    EXPECT_EQ(mr.try_allocate_near(p1, 50, 8), nullptr);
+
+    mr.deallocate(p1, 80, 8);
+}
+
+TEST(DoublyLinkedList, TryOperationsReportExhaustion) {
+    MemoryResource mr(256);
+    mr.set_verbose(false);
+    DoublyLinkedList<int> list(&mr);
+
+    std::size_t pushed = 0;
+    while (list.try_push_back(static_cast<int>(pushed)))
+        ++pushed;
+
+    EXPECT_GT(pushed, 0u);
+    EXPECT_EQ(list.size(), pushed);
+    EXPECT_FALSE(list.try_push_front(-1));
+    EXPECT_EQ(list.try_emplace(list.begin(), -1), list.end());
+    EXPECT_EQ(list.size(), pushed);
+
+    // После освобождения места вставка снова проходит
+    list.pop_back();
+    auto it = list.try_emplace(list.begin(), -1);
+    ASSERT_NE(it, list.end());
+    EXPECT_EQ(list.front(), -1);
+}
+
+TEST(DoublyLinkedList, TryOperationsWithPlainResource) {
+    char buffer[128];
+    std::pmr::monotonic_buffer_resource upstream(buffer, sizeof(buffer),
+                                                 std::pmr::null_memory_resource());
+    DoublyLinkedList<int> list(&upstream);
+
+    while (list.try_push_front(1)) {}
+    EXPECT_FALSE(list.empty());
+    EXPECT_FALSE(list.try_push_back(2));
+}
+
+TEST(DoublyLinkedList, SpliceRelinksWithoutAllocation) {
+    MemoryResource mr(1024);
+    mr.set_verbose(false);
+    DoublyLinkedList<int> a(&mr);
+    DoublyLinkedList<int> b(&mr);
+    for (int i = 1; i <= 3; ++i)
+        a.push_back(i);
+    b.push_back(10);
+
+    std::size_t blocks = mr.allocated_block_count();
+    auto it = a.begin();
+    ++it;
+    const int* node = &*it;
+
+    b.splice(b.begin(), a, it);       // 2 переезжает в начало b
+    a.splice(a.begin(), a, ++a.begin()); // 3 становится первым в a
+
+    EXPECT_EQ(mr.allocated_block_count(), blocks);
+    EXPECT_EQ(&b.front(), node);
+    EXPECT_EQ(a.size(), 2u);
+    EXPECT_EQ(a.front(), 3);
+    EXPECT_EQ(a.back(), 1);
+    EXPECT_EQ(b.size(), 2u);
+    EXPECT_EQ(b.back(), 10);
+}
+
+TEST(LruCache, EvictsLeastRecentlyUsed) {
+    MemoryResource mr(8192);
+    mr.set_verbose(false);
+    {
+        LruCache<int, std::string> cache(3, &mr);
+        cache.put(1, "one");
+        cache.put(2, "two");
+        cache.put(3, "three");
+
+        ASSERT_NE(cache.get(1), nullptr); // 1 становится самым свежим
+        cache.put(4, "four");             // вытесняется 2
+
+        EXPECT_FALSE(cache.contains(2));
+        EXPECT_EQ(*cache.get(1), "one");
+        EXPECT_EQ(*cache.get(4), "four");
+        EXPECT_EQ(cache.get(2), nullptr);
+        EXPECT_EQ(cache.size(), 3u);
+        EXPECT_EQ(cache.evictions(), 1u);
+        EXPECT_EQ(cache.hits(), 3u);
+        EXPECT_EQ(cache.misses(), 1u);
+
+        cache.put(3, "THREE");
+        EXPECT_EQ(*cache.get(3), "THREE");
+        EXPECT_TRUE(cache.erase(3));
+        EXPECT_FALSE(cache.erase(3));
+        EXPECT_EQ(cache.size(), 2u);
+    }
+    // И узлы списка, и хеш-индекс жили в арене
+    EXPECT_EQ(mr.allocated_block_count(), 0u);
+}
+
+TEST(LruCache, SegmentedModeProtectsReusedKeys) {
+    MemoryResource mr(8192);
+    mr.set_verbose(false);
+    LruCache<int, int> cache(5, &mr, CacheMode::SegmentedLru);
+
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.get(1);
+    cache.get(2); // 1 и 2 в защищенном сегменте
+
+    // Однократный проход по новым ключам не вымывает 1 и 2
+    for (int k = 100; k < 120; ++k)
+        cache.put(k, k);
+
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_EQ(cache.size(), 5u);
+}
+
+TEST(LruCache, ExhaustedArenaLeavesCacheConsistent) {
+    // Разные размеры арены, чтобы нехватка памяти пришлась и на узел списка,
+    // и на узел хеш-индекса
+    for (std::size_t arena = 1000; arena <= 2000; arena += 8) {
+        MemoryResource mr(arena);
+        mr.set_verbose(false);
+        {
+            LruCache<int, int> cache(64, &mr);
+            int inserted = 0;
+            try {
+                for (; inserted < 64; ++inserted)
+                    cache.put(inserted, inserted);
+            } catch (const std::bad_alloc&) {
+            }
+
+            std::size_t reachable = 0;
+            for (int k = 0; k < 64; ++k)
+                reachable += cache.contains(k);
+            EXPECT_EQ(cache.size(), reachable) << "arena " << arena;
+            EXPECT_EQ(reachable, static_cast<std::size_t>(inserted)) << "arena " << arena;
+        }
+        EXPECT_EQ(mr.allocated_block_count(), 0u) << "arena " << arena;
+    }
+}
+
+#ifdef PMR_HAVE_SHARED_MEMORY
+TEST(SharedMemoryResource, AllocateAndCoalesce) {
+    const std::string name = "/pmr_test_alloc_" + std::to_string(getpid());
+    SharedMemoryResource mr(name, 4096);
+
+    void* p1 = mr.allocate(100);
+    void* p2 = mr.allocate(200);
+    void* p3 = mr.allocate(50);
+    EXPECT_EQ(mr.allocated_block_count(), 3u);
+    EXPECT_EQ(mr.from_offset(mr.to_offset(p2)), p2);
+
+    mr.deallocate(p1, 100);
+    mr.deallocate(p3, 50);
+    mr.deallocate(p2, 200);
+    EXPECT_EQ(mr.allocated_block_count(), 0u);
+
+    // После слияния снова доступен почти весь сегмент
+    void* big = mr.allocate(3500);
+    mr.deallocate(big, 3500);
+
+    EXPECT_THROW({
+        void* p = mr.allocate(8192);
+        (void)p;
+    }, std::bad_alloc);
+}
+
+TEST(SharedMemoryResource, RejectsSegmentSmallerThanHeader) {
+    const std::string name = "/pmr_test_small_" + std::to_string(getpid());
+    EXPECT_THROW(SharedMemoryResource(name, 64), std::invalid_argument);
+    EXPECT_THROW(SharedMemoryResource(name, 128), std::invalid_argument);
+
+    // Сегмент не создавался, имя свободно
+    SharedMemoryResource mr(name, 4096);
+    EXPECT_TRUE(mr.is_owner());
+}
+
+TEST(SharedList, ChildProcessesReadAndExtendList) {
+    const std::string name = "/pmr_test_list_" + std::to_string(getpid());
+    SharedMemoryResource mr(name, 64 * 1024);
+
+    SharedList<int> list(mr);
+    for (int i = 1; i <= 100; ++i)
+        list.push_back(i);
+    mr.set_root(list.address());
+
+    pid_t readers[3];
+    for (pid_t& pid : readers) {
+        pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            // Отдельное отображение сегмента: адреса отличаются, смещения - нет
+            int code = 1;
+            try {
+                SharedMemoryResource attached(name);
+                SharedList<int> shared(attached, attached.to_offset(attached.root()));
+                long sum = 0;
+                for (int v : shared)
+                    sum += v;
+                code = (sum == 5050 && shared.size() == 100) ? 0 : 2;
+            } catch (...) {
+                code = 3;
+            }
+            _exit(code);
+        }
+    }
+    for (pid_t pid : readers) {
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        ASSERT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+
+    // Дочерний процесс дописывает элемент, родитель видит его без копирования
+    pid_t writer = fork();
+    ASSERT_GE(writer, 0);
+    if (writer == 0) {
+        int code = 1;
+        try {
+            SharedMemoryResource attached(name);
+            SharedList<int> shared(attached, attached.to_offset(attached.root()));
+            shared.push_back(101);
+            code = 0;
+        } catch (...) {
+            code = 3;
+        }
+        _exit(code);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(writer, &status, 0), writer);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    EXPECT_EQ(list.size(), 101u);
+    EXPECT_EQ(list.back(), 101);
+
+    list.destroy();
+    EXPECT_EQ(mr.allocated_block_count(), 0u);
+}
+#endif
+
+TEST(TenantMemoryResource, CountsPerTenant) {
+    MemoryResource mr(4096);
+    mr.set_verbose(false);
+    TenantMemoryResource a(&mr, "a");
+    TenantMemoryResource b(&mr, "b");
+    {
+        DoublyLinkedList<int> list_a(&a);
+        DoublyLinkedList<int> list_b(&b);
+        for (int i = 0; i < 5; ++i)
+            list_a.push_back(i);
+        list_b.push_back(1);
+
+        EXPECT_EQ(a.blocks_in_use(), 5u);
+        EXPECT_EQ(b.blocks_in_use(), 1u);
+        EXPECT_EQ(a.bytes_in_use(), 5 * b.bytes_in_use());
+        EXPECT_EQ(mr.allocated_block_count(), 6u);
+    }
+    EXPECT_EQ(a.bytes_in_use(), 0u);
+    EXPECT_EQ(a.blocks_in_use(), 0u);
+    EXPECT_GT(a.peak_bytes(), 0u);
+}
+
+TEST(TenantMemoryResource, HardQuotaProtectsNeighbors) {
+    MemoryResource mr(4096);
+    mr.set_verbose(false);
+    TenantMemoryResource runaway(&mr, "runaway", 256, QuotaMode::Hard);
+    TenantMemoryResource other(&mr, "other");
+
+    DoublyLinkedList<int> greedy(&runaway);
+    while (greedy.try_push_back(0)) {}
+    EXPECT_LE(runaway.bytes_in_use(), 256u);
+    EXPECT_EQ(runaway.rejected_allocations(), 1u);
+    EXPECT_THROW(greedy.push_back(0), std::bad_alloc);
+
+    // Остальным арендаторам память по-прежнему доступна
+    DoublyLinkedList<int> list(&other);
+    EXPECT_TRUE(list.try_push_back(1));
+}
+
+TEST(TenantMemoryResource, SoftQuotaOnlyCountsViolations) {
+    MemoryResource mr(4096);
+    mr.set_verbose(false);
+    TenantMemoryResource tenant(&mr, "soft", 64, QuotaMode::Soft);
+
+    DoublyLinkedList<int> list(&tenant);
+    for (int i = 0; i < 10; ++i)
+        list.push_back(i);
+
+    EXPECT_EQ(list.size(), 10u);
+    EXPECT_GT(tenant.bytes_in_use(), tenant.quota());
+    EXPECT_GT(tenant.quota_violations(), 0u);
+}
+
+TEST(InlineMemoryResource, ServesSmallListsFromInlineBuffer) {
+    InlineMemoryResource<512> mr;
+    {
+        DoublyLinkedList<int> list(&mr);
+        for (int i = 0; i < 8; ++i)
+            list.push_back(i);
+
+        for (const int& v : list)
+            EXPECT_TRUE(mr.owns(&v));
+        EXPECT_EQ(mr.inline_blocks(), 8u);
+    }
+    EXPECT_EQ(mr.inline_blocks(), 0u);
+    EXPECT_EQ(mr.upstream_allocations(), 0u);
+}
+
+TEST(InlineMemoryResource, OverflowsToUpstream) {
+    MemoryResource upstream(4096);
+    upstream.set_verbose(false);
+    InlineMemoryResource<128> mr(&upstream);
+    {
+        DoublyLinkedList<int> list(&mr);
+        for (int i = 0; i < 20; ++i)
+            list.push_back(i);
+
+        EXPECT_GT(mr.inline_blocks(), 0u);
+        EXPECT_GT(mr.upstream_allocations(), 0u);
+        EXPECT_EQ(upstream.allocated_block_count(), 20u - mr.inline_blocks());
+
+        int expected = 0;
+        for (int v : list)
+            EXPECT_EQ(v, expected++);
+    }
+    EXPECT_EQ(mr.inline_blocks(), 0u);
+    EXPECT_EQ(upstream.allocated_block_count(), 0u);
+}
+
+TEST(InlineMemoryResource, WithoutUpstreamReportsExhaustion) {
+    InlineMemoryResource<128> mr;
+    DoublyLinkedList<int> list(&mr);
+
+    while (list.try_push_back(0)) {}
+    EXPECT_FALSE(list.empty());
+    EXPECT_THROW(list.push_back(1), std::bad_alloc);
+
+    // Освобожденный блок сразу переиспользуется
+    list.pop_front();
+    EXPECT_TRUE(list.try_push_front(2));
+}
+
+struct ByActivity {};
+
+struct Session : IntrusiveListHook<>, IntrusiveListHook<ByActivity> {
+    int id;
+    explicit Session(int i) : id(i) {}
+};
+
+TEST(IntrusiveList, LinksExistingObjectsWithoutAllocation) {
+    Session sessions[] = {Session(1), Session(2), Session(3), Session(4)};
+
+    IntrusiveList<Session> all;
+    for (auto& s : sessions)
+        all.push_back(s);
+
+    // Элементы в списке - те же объекты, без копий
+    EXPECT_EQ(&all.front(), &sessions[0]);
+    EXPECT_EQ(&all.back(), &sessions[3]);
+    EXPECT_EQ(all.size(), 4u);
+
+    // O(1) удаление через сам элемент
+    sessions[1].IntrusiveListHook<>::unlink();
+    std::vector<int> ids;
+    for (const auto& s : all)
+        ids.push_back(s.id);
+    EXPECT_EQ(ids, (std::vector<int>{1, 3, 4}));
+
+    auto it = all.iterator_to(sessions[2]);
+    it = all.erase(it);
+    EXPECT_EQ(it->id, 4);
+    all.insert(it, sessions[1]);
+    EXPECT_EQ((++all.begin())->id, 2);
+
+    all.clear();
+    EXPECT_TRUE(all.empty());
+    EXPECT_FALSE(sessions[0].IntrusiveListHook<>::is_linked());
+}
+
+TEST(IntrusiveList, ObjectInSeveralListsAndAutoUnlink) {
+    IntrusiveList<Session> all;
+    IntrusiveList<Session, ByActivity> active;
+    {
+        Session a(1);
+        Session b(2);
+        all.push_back(a);
+        all.push_back(b);
+        active.push_front(b);
+        active.push_front(a);
+
+        EXPECT_EQ(active.front().id, 1);
+        active.pop_front();
+        EXPECT_EQ(active.front().id, 2);
+        EXPECT_EQ(all.size(), 2u);
+
+        IntrusiveList<Session> moved(std::move(all));
+        EXPECT_TRUE(all.empty());
+        EXPECT_EQ(moved.front().id, 1);
+        all = std::move(moved);
+    }
+    // Разрушенные объекты сами покинули оба списка
+    EXPECT_TRUE(all.empty());
+    EXPECT_TRUE(active.empty());
+}
+
+TEST(Requirements, IntrusiveForwardIterator) {
+    using Iterator = IntrusiveList<Session>::iterator;
+    using ConstIterator = IntrusiveList<Session>::const_iterator;
+    static_assert(std::is_same<std::iterator_traits<Iterator>::iterator_category,
+                               std::forward_iterator_tag>::value,
+                  "Must be forward iterator");
+    static_assert(std::is_same<std::iterator_traits<ConstIterator>::iterator_category,
+                               std::forward_iterator_tag>::value,
+                  "Must be forward iterator");
+    SUCCEED();
+}
+
+TEST(AllocationProfiler, AttributesLiveBytesToTags) {
+    AllocationProfiler profiler(64);
+    std::vector<char> blocks(4000);
+
+    // Каждый блок: 16 байт, половина - "nodes", половина - "payload"
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        ProfileScope scope(i % 2 ? "payload" : "nodes");
+        if (profiler.should_sample(16))
+            profiler.record(&blocks[i], 16);
+    }
+
+    auto sites = profiler.snapshot();
+    ASSERT_EQ(sites.size(), 2u);
+    double total = sites[0].live_bytes + sites[1].live_bytes;
+    // Оценка близка к реальным 64000 байтам
+    EXPECT_GT(total, 64000 * 0.7);
+    EXPECT_LT(total, 64000 * 1.3);
+
+    for (char& c : blocks)
+        profiler.release(&c);
+    EXPECT_EQ(profiler.live_samples(), 0u);
+    EXPECT_TRUE(profiler.snapshot().empty());
+
+    std::ostringstream out;
+    profiler.dump(out);
+    EXPECT_NE(out.str().find("Heap profile"), std::string::npos);
+}
+
+#ifdef PMR_ENABLE_PROFILER
+TEST(AllocationProfiler, TracksSampledBlocksInMemoryResource) {
+    MemoryResource mr(64 * 1024);
+    mr.set_verbose(false);
+    AllocationProfiler profiler(1);  // каждая аллокация попадает в выборку
+    mr.set_profiler(&profiler);
+    {
+        ProfileScope scope("list");
+        DoublyLinkedList<int> list(&mr);
+        for (int i = 0; i < 10; ++i)
+            list.push_back(i);
+        EXPECT_EQ(profiler.live_samples(), 10u);
+
+        auto sites = profiler.snapshot();
+        ASSERT_EQ(sites.size(), 1u);
+        EXPECT_EQ(sites[0].site, "list");
+    }
+    EXPECT_EQ(profiler.live_samples(), 0u);
+    mr.set_profiler(nullptr);
+}
+
+#ifdef __GLIBC__
+TEST(AllocationProfiler, OneCallerIsOneSiteWithoutTag) {
+    MemoryResource mr(64 * 1024);
+    mr.set_verbose(false);
+    AllocationProfiler profiler(1);
+    mr.set_profiler(&profiler);
+    {
+        DoublyLinkedList<int> list(&mr);
+        void* blocker = nullptr;
+        for (int i = 0; i < 10; ++i) {
+            // Первый узел идет без подсказки (try_allocate), остальные - через
+            // try_allocate_near: внутренние кадры арены у них разные
+            list.push_back(i);
+            if (i == 4)
+                blocker = mr.allocate(64, 8);
+        }
+        EXPECT_EQ(profiler.live_samples(), 11u);
+
+        // blocker и узлы списка - два разных места вызова
+        auto sites = profiler.snapshot();
+        ASSERT_EQ(sites.size(), 2u);
+        std::size_t list_samples = std::max(sites[0].live_samples, sites[1].live_samples);
+        EXPECT_EQ(list_samples, 10u);
+
+        mr.deallocate(blocker, 64, 8);
+    }
+    EXPECT_EQ(profiler.live_samples(), 0u);
+    mr.set_profiler(nullptr);
+}
+#endif
+#endif
+
 TEST(Requirements, ForwardIterator) {
     // Проверяем, что итератор действительно является forward_iterator
     using Iterator = DoublyLinkedList<int>::iterator;
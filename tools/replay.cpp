@@ -0,0 +1,240 @@
+// Воспроизведение трассы аллокаций (см. AllocationTrace.h) на выбранном
+// memory_resource.
+//
+// Использование:
+//   replay <trace-file> [resource] [arena-bytes]
+//
+// resource: first-fit (по умолчанию), next-fit, best-fit, segregated,
+//           new-delete, pool, monotonic
+//
+// Печатает распределение задержек allocate/deallocate, пиковый объем живых
+// данных и (для арен BasicMemoryResource) фрагментацию во времени.
+
+#include "AllocationTrace.h"
+#include "MemoryResource.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Есть ли у ресурса статистика свободной памяти (BasicMemoryResource)
+template <typename R, typename = void>
+struct has_free_stats : std::false_type {};
+
+template <typename R>
+struct has_free_stats<R, std::void_t<decltype(std::declval<const R &>().largest_free_block()),
+                                     decltype(std::declval<const R &>().free_bytes())>>
+    : std::true_type {};
+
+struct Sample
+{
+    std::size_t op_index;
+    std::size_t live_bytes;
+    std::size_t used_bytes;    // занято в арене с учетом накладных расходов
+    double fragmentation;      // 1 - наибольший свободный блок / вся свободная память
+};
+
+struct ReplayStats
+{
+    std::vector<double> allocate_ns;
+    std::vector<double> deallocate_ns;
+    std::size_t peak_live_bytes = 0;
+    std::size_t peak_used_bytes = 0;
+    std::size_t failures = 0;
+    std::vector<Sample> timeline;
+};
+
+template <typename Resource>
+Sample sample(const Resource &mr, std::size_t op_index, std::size_t live_bytes)
+{
+    Sample s{op_index, live_bytes, 0, 0.0};
+    if constexpr (has_free_stats<Resource>::value)
+    {
+        std::size_t free_bytes = mr.free_bytes();
+        s.used_bytes = mr.capacity() - free_bytes;
+        if (free_bytes)
+            s.fragmentation = 1.0 - static_cast<double>(mr.largest_free_block()) / free_bytes;
+    }
+    return s;
+}
+
+template <typename Resource>
+ReplayStats replay(const std::vector<TraceRecord> &records, Resource &mr)
+{
+    using clock = std::chrono::steady_clock;
+
+    // load_trace гарантирует id < records.size() и допустимое выравнивание
+    std::vector<void *> live(records.size(), nullptr);
+    std::vector<const TraceRecord *> origin(live.size(), nullptr);
+    std::size_t live_bytes = 0;
+    const std::size_t sample_every = std::max<std::size_t>(1, records.size() / 20);
+
+    ReplayStats stats;
+    stats.allocate_ns.reserve(records.size() / 2 + 1);
+    stats.deallocate_ns.reserve(records.size() / 2 + 1);
+
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        const TraceRecord &r = records[i];
+        std::size_t alignment = std::size_t(1) << r.alignment_log2;
+
+        if (r.op == TraceOp::Allocate)
+        {
+            auto start = clock::now();
+            try
+            {
+                live[r.id] = mr.allocate(r.size, alignment);
+            }
+            catch (const std::bad_alloc &)
+            {
+                ++stats.failures;
+                continue;
+            }
+            stats.allocate_ns.push_back(
+                std::chrono::duration<double, std::nano>(clock::now() - start).count());
+            origin[r.id] = &r;
+            live_bytes += r.size;
+        }
+        else if (live[r.id])
+        {
+            auto start = clock::now();
+            mr.deallocate(live[r.id], r.size, alignment);
+            stats.deallocate_ns.push_back(
+                std::chrono::duration<double, std::nano>(clock::now() - start).count());
+            live[r.id] = nullptr;
+            live_bytes -= r.size;
+        }
+
+        stats.peak_live_bytes = std::max(stats.peak_live_bytes, live_bytes);
+        if constexpr (has_free_stats<Resource>::value)
+            stats.peak_used_bytes = std::max(stats.peak_used_bytes, mr.capacity() - mr.free_bytes());
+
+        if (i % sample_every == 0 || i + 1 == records.size())
+            stats.timeline.push_back(sample(mr, i, live_bytes));
+    }
+
+    // Освобождаем то, что трасса оставила живым
+    for (std::size_t id = 0; id < live.size(); ++id)
+    {
+        if (live[id])
+            mr.deallocate(live[id], origin[id]->size, std::size_t(1) << origin[id]->alignment_log2);
+    }
+
+    return stats;
+}
+
+void print_latency(const char *label, std::vector<double> values)
+{
+    if (values.empty())
+    {
+        std::printf("%-12s (no operations)\n", label);
+        return;
+    }
+
+    std::sort(values.begin(), values.end());
+    auto pct = [&](double p) { return values[static_cast<std::size_t>(p * (values.size() - 1))]; };
+    std::printf("%-12s %10zu %10.0f %10.0f %10.0f %10.0f\n",
+                label, values.size(), pct(0.50), pct(0.90), pct(0.99), values.back());
+}
+
+void print_report(const ReplayStats &stats, bool has_arena_stats)
+{
+    std::printf("\n%-12s %10s %10s %10s %10s %10s\n", "latency, ns", "count", "p50", "p90", "p99", "max");
+    print_latency("allocate", stats.allocate_ns);
+    print_latency("deallocate", stats.deallocate_ns);
+
+    std::printf("\npeak live bytes: %zu\n", stats.peak_live_bytes);
+    if (has_arena_stats)
+        std::printf("peak arena usage: %zu bytes\n", stats.peak_used_bytes);
+    std::printf("failed allocations: %zu\n", stats.failures);
+
+    std::printf("\n%10s %12s %12s %10s\n", "op", "live bytes", "arena used", "frag");
+    for (const Sample &s : stats.timeline)
+    {
+        if (has_arena_stats)
+            std::printf("%10zu %12zu %12zu %10.3f\n", s.op_index, s.live_bytes, s.used_bytes, s.fragmentation);
+        else
+            std::printf("%10zu %12zu %12s %10s\n", s.op_index, s.live_bytes, "-", "-");
+    }
+}
+
+template <typename Resource>
+void run_arena(const std::vector<TraceRecord> &records, std::size_t arena_size)
+{
+    Resource mr(arena_size);
+    mr.set_verbose(false);
+    print_report(replay(records, mr), true);
+}
+
+template <typename Resource>
+void run_pmr(const std::vector<TraceRecord> &records, Resource &mr)
+{
+    print_report(replay(records, mr), false);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <trace-file> [resource] [arena-bytes]\n", argv[0]);
+        return 2;
+    }
+
+    try
+    {
+        const std::vector<TraceRecord> records = load_trace(argv[1]);
+        const std::string resource = argc > 2 ? argv[2] : "first-fit";
+        const std::size_t arena_size = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1024 * 1024;
+
+        std::printf("trace: %s (%zu records), resource: %s\n", argv[1], records.size(), resource.c_str());
+
+        std::size_t clamped = 0;
+        for (const TraceRecord &r : records)
+            clamped += (r.flags & kTraceSizeClamped) != 0;
+        if (clamped)
+            std::printf("warning: %zu records have sizes above 4 GiB, replayed as %u bytes\n",
+                        clamped, std::numeric_limits<std::uint32_t>::max());
+
+        if (resource == "first-fit")
+            run_arena<MemoryResource>(records, arena_size);
+        else if (resource == "next-fit")
+            run_arena<NextFitMemoryResource>(records, arena_size);
+        else if (resource == "best-fit")
+            run_arena<BestFitMemoryResource>(records, arena_size);
+        else if (resource == "segregated")
+            run_arena<SegregatedMemoryResource>(records, arena_size);
+        else if (resource == "new-delete")
+            run_pmr(records, *std::pmr::new_delete_resource());
+        else if (resource == "pool")
+        {
+            std::pmr::unsynchronized_pool_resource pool;
+            run_pmr(records, pool);
+        }
+        else if (resource == "monotonic")
+        {
+            std::pmr::monotonic_buffer_resource monotonic;
+            run_pmr(records, monotonic);
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown resource: %s\n", resource.c_str());
+            return 2;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file